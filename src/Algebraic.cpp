@@ -27,8 +27,11 @@ THE SOFTWARE.
 #include "Graph.hpp"
 #include "Theory.hpp"
 
-#include <limits>
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <map>
+#include <numeric>
 #include <cstdio>
 
 using namespace std;
@@ -49,103 +52,192 @@ void Permutation::addFromTo(BLit from, BLit to)
     }
 }
 
-void Permutation::addPrimeSplitToVector(
-    vector<shared_ptr<Permutation> >& newPerms)
+///Smallest prime factor of every n < spfTableSize, cycles are rarely longer
+static const size_t spfTableSize = 1 << 16;
+
+static const vector<uint32_t>& smallestPrimeFactors()
+{
+    static const vector<uint32_t> spf = [] {
+        vector<uint32_t> t(spfTableSize, 0);
+        for (size_t i = 2; i < spfTableSize; i++) {
+            if (t[i] != 0) continue;
+            for (size_t j = i; j < spfTableSize; j += i) {
+                if (t[j] == 0) t[j] = i;
+            }
+        }
+        return t;
+    }();
+    return spf;
+}
+
+static size_t smallestPrimeFactor(size_t n)
+{
+    if (n < spfTableSize) {
+        return smallestPrimeFactors()[n];
+    }
+    if (n % 2 == 0) return 2;
+    for (size_t d = 3; d * d <= n; d += 2) {
+        if (n % d == 0) return d;
+    }
+    return n;
+}
+
+static size_t intPow(size_t base, size_t exp)
 {
-    std::map<size_t, vector<vector<BLit> > > lengthToCycles;
-    std::map<size_t, std::set<size_t> > primeToPowers;
+    size_t r = 1;
+    while (exp-- > 0) r *= base;
+    return r;
+}
 
-    //First, we split each cycle up in its relative prime components.
-    //E.g., if we have a cycle of length 2^3 * 3 * 5^2
-    //We will split it up in 2^3, 3 and 5^2.
-    //We also store the information that 2, 3 and 5 are occurring prime components.
-    //The prime2powers then contains the information that for
-    //   prime 2, power 3 occurs, for prime 3, power 1 etc.
+///base^exp modulo mod, mod < 2^32 so that products fit 64 bits
+static uint64_t powMod(uint64_t base, size_t exp, uint64_t mod)
+{
+    uint64_t r = 1 % mod;
+    base %= mod;
+    while (exp > 0) {
+        if (exp & 1) r = r * base % mod;
+        base = base * base % mod;
+        exp >>= 1;
+    }
+    return r;
+}
 
+static size_t primeValuation(size_t n, size_t prime)
+{
+    size_t power = 0;
+    while (n % prime == 0) {
+        power++;
+        n /= prime;
+    }
+    return power;
+}
+
+///A cycle of the permutation, stored in a shared buffer of literals
+struct CycleRef {
+    size_t start;
+    size_t len;
+};
+
+///Powers of a prime that occur in the cycle lengths
+struct PrimePowers {
+    size_t smallest;
+    size_t biggest;
+};
+
+void Permutation::addPrimeSplitToVector(
+    vector<shared_ptr<Permutation> >& newPerms)
+{
+    //All the cycles, one after the other in lits
+    vector<BLit> lits;
+    lits.reserve(supportSize());
+    vector<CycleRef> cycles;
+    vector<BLit> cycle;
+
+    //First, we factor each cycle length.
+    //E.g., a cycle of length 2^3 * 3 * 5^2 has prime components 2^3, 3
+    //and 5^2. For each prime, we keep the smallest and biggest power
+    //occurring in a cycle length; the order m of the permutation is the
+    //product of the biggest powers.
+    std::map<size_t, PrimePowers> primeToPowers;
     for (auto l : getCycleReprs()) {
-        vector<BLit> cycle;
         getCycle(l, cycle);
-        auto cycleSize = cycle.size();
-        for (size_t i = 2; i <= cycleSize; i++) {
-            size_t nbOcc = 0;
-            while (cycleSize % i == 0) {
-                nbOcc++;
-                cycleSize /= i;
-            }
-            if (nbOcc != 0) {
-                size_t newCycleLength = (size_t)pow(i, nbOcc);
-                if (primeToPowers.find(i) == primeToPowers.cend()) {
-                    primeToPowers[i] = {};
-                }
-                primeToPowers[i].insert(nbOcc);
-                if (lengthToCycles.find(newCycleLength) ==
-                    lengthToCycles.cend()) {
-                    lengthToCycles[newCycleLength] = {};
-                }
-                size_t nbNewCycles = cycle.size() / newCycleLength;
-                for (size_t j = 0; j < nbNewCycles; j++) {
-                    vector<BLit> newCycle;
-                    for (size_t k = 0; k < newCycleLength; k++) {
-                        newCycle.push_back(cycle[j + nbNewCycles * k]);
-                    }
-                    lengthToCycles[newCycleLength].push_back(newCycle);
-                }
+        cycles.push_back({lits.size(), cycle.size()});
+        lits.insert(lits.end(), cycle.begin(), cycle.end());
+        size_t rest = cycle.size();
+        while (rest > 1) {
+            const size_t prime = smallestPrimeFactor(rest);
+            const size_t power = primeValuation(rest, prime);
+            rest /= intPow(prime, power);
+            auto it = primeToPowers.find(prime);
+            if (it == primeToPowers.end()) {
+                primeToPowers[prime] = {power, power};
+            } else {
+                it->second.smallest = std::min(it->second.smallest, power);
+                it->second.biggest = std::max(it->second.biggest, power);
             }
         }
     }
 
-    //Next, we split up the permutation as much as possible.
-    //First of all, if there are different relative prime components, we can forget about the original permutation: for each prime component, we keep that generator
-    //Next: for each prime component, we also wish to keep "special" generators, namely those that have cycles of equal length. There can be multiple of those.
-
-    for (auto p2p : primeToPowers) {
-        auto prime = p2p.first;
-        auto powers = p2p.second;
-
-        auto genPerm = std::make_shared<Permutation>(conf);
-        size_t smallestPow = SIZE_MAX;
-        size_t biggestPow = 0;
-        for (auto power : powers) {
-            smallestPow = min(power, smallestPow);
-            biggestPow = max(power, biggestPow);
-            for (auto c : lengthToCycles[pow(prime, power)]) {
-                genPerm->addCycle(c);
+    //Next, we split up the permutation as much as possible, into powers
+    //of it, so that every generator is a symmetry as well.
+    //For each prime q with biggest power E, p^(m/q^E) generates the q-part
+    //of <p>; if there are different relative prime components, we can
+    //forget about the original permutation and keep these generators.
+    //Next: for each prime component, we also wish to keep "special"
+    //generators p^(m/q^s) for smaller powers s, whose longest cycles have
+    //length q^s. There can be multiple of those.
+    //The exponents are too big to compute, so only their residue modulo
+    //each cycle length is.
+
+    vector<size_t> order(cycles.size());
+    vector<uint64_t> steps(cycles.size());
+    for (const auto& p2p : primeToPowers) {
+        const size_t prime = p2p.first;
+        const size_t biggestPow = p2p.second.biggest;
+
+        //cycles by increasing power of the prime in their length
+        for (size_t c = 0; c < cycles.size(); c++) {
+            order[c] = c;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return primeValuation(cycles[a].len, prime)
+                < primeValuation(cycles[b].len, prime);
+        });
+
+        //m/q^E modulo each cycle length
+        for (size_t c = 0; c < cycles.size(); c++) {
+            const uint64_t len = cycles[c].len;
+            uint64_t step = 1 % len;
+            for (const auto& other : primeToPowers) {
+                if (other.first != prime) {
+                    step = step * powMod(other.first, other.second.biggest, len) % len;
+                }
             }
+            steps[c] = step;
         }
 
-        newPerms.push_back(genPerm);
-
-        while (smallestPow >= 1) {
-            if (smallestPow == biggestPow) {
-                smallestPow--;
-                continue;
-            }
-            auto equalCycleGen = std::make_shared<Permutation>(conf);
-            for (auto power : powers) {
-                for (auto c : lengthToCycles[pow(prime, power)]) {
-                    size_t cycleLength = pow(prime, smallestPow);
-                    size_t jump = c.size() / cycleLength;
-                    for (size_t i = 0; i < jump; i++) {
-                        vector<BLit> newCycle;
-                        for (size_t j = 0; j < cycleLength; j++) {
-                            newCycle.push_back(c[i + j * jump]);
-                        }
-                        equalCycleGen->addCycle(newCycle);
+        auto addPower = [&](size_t pow) {
+            //p^(m/q^pow) = (p^(m/q^E))^(q^(E-pow))
+            auto genPerm = std::make_shared<Permutation>(conf);
+            for (size_t c : order) {
+                const size_t len = cycles[c].len;
+                const size_t step =
+                    steps[c] * powMod(prime, biggestPow - pow, len) % len;
+                const size_t nbNewCycles = std::gcd(len, step);
+                if (nbNewCycles == len) continue;
+                const BLit* lit = lits.data() + cycles[c].start;
+                for (size_t i = 0; i < nbNewCycles; i++) {
+                    cycle.clear();
+                    for (size_t j = i; cycle.size() < len / nbNewCycles; j = (j + step) % len) {
+                        cycle.push_back(lit[j]);
                     }
+                    genPerm->addCycle(cycle);
                 }
             }
+            newPerms.push_back(genPerm);
+        };
 
-            newPerms.push_back(equalCycleGen);
-            smallestPow--;
+        addPower(biggestPow);
+        for (size_t pow = p2p.second.smallest; pow >= 1; pow--) {
+            if (pow != biggestPow) {
+                addPower(pow);
+            }
         }
     }
 }
 
 void Permutation::addCycle(vector<BLit>& cyc)
 {
-    uint32_t n = cyc.size();
-    for (uint32_t i = 0; i < n; ++i) {
-        addFromTo(cyc.at(i), cyc.at((i + 1) % n));
+    addCycle(cyc.data(), cyc.size());
+}
+
+void Permutation::addCycle(const BLit* cyc, size_t n)
+{
+    for (size_t i = 0; i + 1 < n; ++i) {
+        addFromTo(cyc[i], cyc[i + 1]);
+    }
+    if (n > 0) {
+        addFromTo(cyc[n - 1], cyc[0]);
     }
 }
 
@@ -343,6 +435,387 @@ bool Permutation::equals(shared_ptr<Permutation> other)
     return true;
 }
 
+// =========StabilizerChain=========================
+
+static const uint32_t noPoint = std::numeric_limits<uint32_t>::max();
+
+/// Schreier-Sims stabilizer chain of the group generated by the permutations
+/// given to add(), acting on the points 0..n-1. Every coset representative
+/// is a product of the added permutations, so a permutation that strips to
+/// the identity is in the group even if the chain is not complete yet.
+/// The permutation being stripped is multiplied with the strong generators
+/// only on their support, which is usually much smaller than n
+class StabilizerChain
+{
+public:
+    typedef vector<uint32_t> Perm;
+
+    StabilizerChain(uint32_t _n, int64_t& _steps) :
+        n(_n), steps(_steps), h(_n), hInv(_n)
+    {
+        clear();
+    }
+
+    ///true iff p is in the group; false may also mean out of steps
+    bool contains(const Perm& p)
+    {
+        load(p);
+        strip(0);
+        const bool member = (moved == 0);
+        clear();
+        return member;
+    }
+
+    ///add p to the generators and complete the chain
+    void add(const Perm& p)
+    {
+        load(p);
+        const uint32_t lev = strip(0);
+        if (moved > 0) addStrongGen(0, lev);
+    }
+
+    bool outOfSteps() const
+    {
+        return steps <= 0;
+    }
+
+    ///the order of the group is the product of the orbit sizes of
+    ///the levels, once the chain is complete
+    uint32_t nbLevels() const
+    {
+        return levels.size();
+    }
+
+    uint32_t orbitSize(uint32_t lev) const
+    {
+        return levels[lev].orbit.size();
+    }
+
+private:
+    struct Gen {
+        Perm perm;
+        Perm inv;
+        vector<uint32_t> supp;
+    };
+
+    struct Level {
+        uint32_t base;
+        vector<uint32_t> gens; ///<indices into strong
+        vector<uint32_t> orbit;
+        ///the index into gens of the generator that maps a point earlier in
+        ///the orbit to this one, noPoint outside the orbit and for the base
+        vector<uint32_t> via;
+        ///the number of gens whose Schreier generators were already sifted
+        ///for each orbit point
+        vector<uint32_t> checked;
+    };
+
+    uint32_t n;
+    int64_t& steps; ///<shared by the chains of a group
+    vector<Gen> strong;
+    vector<Level> levels;
+
+    ///the permutation being stripped, its inverse and the number
+    ///of points it moves
+    Perm h;
+    Perm hInv;
+    uint32_t moved;
+    vector<uint32_t> tmp;
+
+    void clear()
+    {
+        for (uint32_t i = 0; i < n; ++i) {
+            h[i] = i;
+            hInv[i] = i;
+        }
+        moved = 0;
+    }
+
+    void load(const Perm& p)
+    {
+        moved = 0;
+        for (uint32_t i = 0; i < n; ++i) {
+            h[i] = p[i];
+            hInv[p[i]] = i;
+            moved += (p[i] != i);
+        }
+        steps -= n;
+    }
+
+    /// h := h g
+    void rightMultiply(const Perm& g, const vector<uint32_t>& supp)
+    {
+        tmp.clear();
+        for (const uint32_t p : supp) tmp.push_back(h[g[p]]);
+        for (uint32_t k = 0; k < supp.size(); ++k) {
+            const uint32_t p = supp[k];
+            moved += (tmp[k] != p) - (h[p] != p);
+            h[p] = tmp[k];
+            hInv[tmp[k]] = p;
+        }
+        steps -= supp.size();
+    }
+
+    /// h := g h
+    void leftMultiply(const Perm& g, const vector<uint32_t>& supp)
+    {
+        tmp.clear();
+        for (const uint32_t y : supp) tmp.push_back(hInv[y]);
+        for (uint32_t k = 0; k < supp.size(); ++k) {
+            const uint32_t i = tmp[k];
+            const uint32_t y = g[supp[k]];
+            moved += (y != i) - (h[i] != i);
+            h[i] = y;
+            hInv[y] = i;
+        }
+        steps -= supp.size();
+    }
+
+    /// h := g^-1 h for the coset representatives g of levels lev, lev+1, ...
+    /// returns the level whose orbit misses the image of the base point,
+    /// levels.size() if h fixes all base points
+    uint32_t strip(uint32_t lev)
+    {
+        for (; lev < levels.size() && moved > 0; ++lev) {
+            const Level& l = levels[lev];
+            uint32_t x = h[l.base];
+            if (x != l.base && l.via[x] == noPoint) return lev;
+            while (x != l.base) {
+                const Gen& g = strong[l.gens[l.via[x]]];
+                leftMultiply(g.inv, g.supp);
+                x = g.inv[x];
+            }
+        }
+        return moved > 0 ? lev : levels.size();
+    }
+
+    /// h fixes the base points of the levels below last, add it to the
+    /// generators of levels first..last, then complete them
+    void addStrongGen(uint32_t first, uint32_t last)
+    {
+        const uint32_t idx = strong.size();
+        strong.push_back(Gen());
+        Gen& g = strong.back();
+        g.perm = h;
+        g.inv = hInv;
+        for (uint32_t i = 0; i < n; ++i) {
+            if (h[i] != i) g.supp.push_back(i);
+        }
+        steps -= 3 * (int64_t)n;
+        clear();
+
+        if (last == levels.size()) {
+            Level l;
+            l.base = g.supp[0];
+            l.orbit.push_back(l.base);
+            l.via.resize(n, noPoint);
+            l.checked.push_back(0);
+            levels.push_back(l);
+            steps -= n;
+        }
+        for (uint32_t lev = first; lev <= last; ++lev) {
+            levels[lev].gens.push_back(idx);
+            extendOrbit(lev);
+        }
+        for (uint32_t lev = last + 1; lev-- > first;) {
+            complete(lev);
+        }
+    }
+
+    void extendOrbit(uint32_t lev)
+    {
+        Level& l = levels[lev];
+        const size_t oldSize = l.orbit.size();
+        const uint32_t newGen = l.gens.size() - 1;
+        for (size_t i = 0; i < l.orbit.size(); ++i) {
+            for (uint32_t k = i < oldSize ? newGen : 0; k < l.gens.size(); ++k) {
+                const uint32_t y = strong[l.gens[k]].perm[l.orbit[i]];
+                if (y != l.base && l.via[y] == noPoint) {
+                    l.via[y] = k;
+                    l.orbit.push_back(y);
+                    l.checked.push_back(0);
+                }
+            }
+        }
+    }
+
+    /// sift the Schreier generators of level lev not sifted yet,
+    /// adding the non-trivial residues as new strong generators
+    void complete(uint32_t lev)
+    {
+        for (size_t i = 0; i < levels[lev].orbit.size(); ++i) {
+            while (levels[lev].checked[i] < levels[lev].gens.size()) {
+                if (outOfSteps()) return;
+                const Level& l = levels[lev];
+                const uint32_t k = l.checked[i];
+                levels[lev].checked[i]++;
+                const uint32_t x = l.orbit[i];
+                const Gen& s = strong[l.gens[k]];
+
+                // trivial, s is the edge of the Schreier tree from x to s(x)
+                const uint32_t sx = s.perm[x];
+                if (sx != l.base && l.via[sx] == k && s.inv[sx] == x) continue;
+
+                // h = u_{s(x)}^-1 s u_x fixes the base point of lev
+                rightMultiply(s.perm, s.supp);
+                for (uint32_t y = x; y != l.base;) {
+                    const Gen& g = strong[l.gens[l.via[y]]];
+                    rightMultiply(g.perm, g.supp);
+                    y = g.inv[y];
+                }
+                const uint32_t last = strip(lev);
+                if (moved > 0) addStrongGen(lev + 1, last);
+            }
+        }
+    }
+};
+
+///Union-find on the points 0..n-1
+class DisjointSets
+{
+public:
+    DisjointSets(uint32_t n) :
+        parent(n)
+    {
+        for (uint32_t i = 0; i < n; ++i) parent[i] = i;
+    }
+
+    uint32_t find(uint32_t x)
+    {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    void merge(uint32_t x, uint32_t y)
+    {
+        parent[find(x)] = find(y);
+    }
+
+private:
+    vector<uint32_t> parent;
+};
+
+/// The generators of a group as permutations of its points, which are the
+/// permuted literals and their negations. The support of each generator is
+/// in one connected component of the points, and the group is the direct
+/// product of the groups of the components, so each of them gets its own,
+/// much smaller, stabilizer chain
+class GroupChains
+{
+public:
+    GroupChains(const std::unordered_set<BLit>& support,
+                const vector<shared_ptr<Permutation> >& gens, int64_t _steps) :
+        steps(_steps)
+    {
+        for (const auto& l : support) {
+            points.push_back(l);
+            if (!support.count(~l)) points.push_back(~l);
+        }
+        std::sort(points.begin(), points.end());
+        const uint32_t n = points.size();
+        index.resize(points.empty() ? 0 : points.back().toInt() + 2);
+        for (uint32_t i = 0; i < n; ++i) index[points[i].toInt()] = i;
+
+        DisjointSets comps(n);
+        for (const auto& p : gens) {
+            for (uint32_t i = 0; i < p->supportSize(); ++i) {
+                comps.merge(point(p->domain[i]), point(p->domain[0]));
+                comps.merge(point(~p->domain[i]), point(p->domain[0]));
+            }
+        }
+        comp.resize(n);
+        local.resize(n);
+        compSize.resize(n, 0);
+        for (uint32_t i = 0; i < n; ++i) {
+            comp[i] = comps.find(i);
+            local[i] = compSize[comp[i]]++;
+        }
+        chains.resize(n);
+    }
+
+    uint32_t nbPoints() const
+    {
+        return points.size();
+    }
+
+    uint32_t point(BLit l) const
+    {
+        return index[l.toInt()];
+    }
+
+    /// the chain of the component of p, with p on its points in perm();
+    /// NULL if p is not a permutation once the negations are added
+    StabilizerChain* load(const Permutation& p)
+    {
+        if (p.supportSize() == 0) return NULL;
+        const uint32_t c = comp[point(p.domain[0])];
+        img.resize(compSize[c]);
+        for (uint32_t i = 0; i < img.size(); ++i) img[i] = i;
+        for (uint32_t i = 0; i < p.supportSize(); ++i) {
+            img[local[point(p.domain[i])]] = local[point(p.image[i])];
+            img[local[point(~p.domain[i])]] = local[point(~p.image[i])];
+        }
+        hit.assign(img.size(), 0);
+        for (uint32_t i = 0; i < img.size(); ++i) {
+            if (hit[img[i]]) return NULL;
+            hit[img[i]] = 1;
+        }
+        if (!chains[c]) chains[c].reset(new StabilizerChain(img.size(), steps));
+        return chains[c].get();
+    }
+
+    const StabilizerChain::Perm& perm() const
+    {
+        return img;
+    }
+
+    const vector<std::unique_ptr<StabilizerChain> >& getChains() const
+    {
+        return chains;
+    }
+
+    ///shared by the chains, the chains may be incomplete once it is <= 0
+    int64_t steps;
+
+private:
+    vector<BLit> points;
+    vector<uint32_t> index; ///<point of each literal
+    vector<uint32_t> comp; ///<component of each point
+    vector<uint32_t> local; ///<index of each point in its component
+    vector<uint32_t> compSize;
+    vector<std::unique_ptr<StabilizerChain> > chains; ///<by component
+    StabilizerChain::Perm img;
+    vector<char> hit;
+};
+
+///num := num * f, on base 10^9 digits, least significant first
+static void multiplyDecimal(vector<uint32_t>& num, uint32_t f)
+{
+    uint64_t carry = 0;
+    for (auto& d : num) {
+        const uint64_t x = (uint64_t)d * f + carry;
+        d = x % 1000000000;
+        carry = x / 1000000000;
+    }
+    while (carry > 0) {
+        num.push_back(carry % 1000000000);
+        carry /= 1000000000;
+    }
+}
+
+static string decimalToString(const vector<uint32_t>& num)
+{
+    string s = std::to_string(num.back());
+    for (size_t i = num.size() - 1; i-- > 0;) {
+        const string d = std::to_string(num[i]);
+        s += string(9 - d.size(), '0') + d;
+    }
+    return s;
+}
+
 // =========Group=========================
 
 Group::Group(Config* _conf) :
@@ -394,6 +867,13 @@ void Group::get_perms_to(vector<std::unordered_map<BLit, BLit>>& out)
     }
 }
 
+void Group::visitPermutations(const BID::PermVisitor& visitor) const
+{
+    for (const auto& p : permutations) {
+        visitor(p->domain.data(), p->image.data(), p->domain.size());
+    }
+}
+
 // Adds to matrix 3 rows if an initialmatrix is found.
 // The first added row is the shared row.
 // The matrix is then maximally extended with new rows given the detected permutations for this group.
@@ -557,6 +1037,90 @@ void Group::cleanPermutations(shared_ptr<Matrix> matrix)
     }
 }
 
+uint32_t Group::getGenerators(vector<shared_ptr<Permutation> >& out)
+{
+    for (auto m : matrices) {
+        for (uint32_t idx = 0; idx + 1 < m->nbRows(); ++idx) {
+            out.push_back(shared_ptr<Permutation>(
+                new Permutation(*m->getRow(idx), *m->getRow(idx + 1), conf)));
+        }
+    }
+    const uint32_t nbRowSwaps = out.size();
+    out.insert(out.end(), permutations.cbegin(), permutations.cend());
+    return nbRowSwaps;
+}
+
+uint32_t Group::removeRedundantGenerators()
+{
+    vector<shared_ptr<Permutation> > gens;
+    const uint32_t nbRowSwaps = getGenerators(gens);
+    GroupChains chains(support, gens, conf->stabChainStepsLim);
+
+    // keep the first of the generators that generate each other,
+    // in the order they were found; the row swaps are always kept
+    uint32_t removed = 0;
+    permutations.clear();
+    for (uint32_t i = 0; i < gens.size(); ++i) {
+        StabilizerChain* chain = chains.load(*gens[i]);
+        if (i >= nbRowSwaps) {
+            if (chain && chain->contains(chains.perm())) {
+                removed++;
+                continue;
+            }
+            permutations.push_back(gens[i]);
+        }
+        if (chain && chains.steps > 0) chain->add(chains.perm());
+    }
+
+    if (conf->verbosity > 1 && chains.steps <= 0) {
+        cout << "c Out of steps checking for redundant generators, some may be kept" << endl;
+    }
+    return removed;
+}
+
+void Group::getStats(BID::SubgroupStats& stats)
+{
+    vector<shared_ptr<Permutation> > gens;
+    getGenerators(gens);
+    GroupChains chains(support, gens, conf->stabChainStepsLim);
+
+    stats.max_cycle = 0;
+    DisjointSets orbits(chains.nbPoints());
+    for (auto p : gens) {
+        stats.max_cycle = std::max(stats.max_cycle, p->getMaxCycleSize());
+        for (uint32_t i = 0; i < p->supportSize(); ++i) {
+            orbits.merge(chains.point(p->domain[i]), chains.point(p->image[i]));
+            orbits.merge(chains.point(~p->domain[i]), chains.point(~p->image[i]));
+        }
+        StabilizerChain* chain = chains.load(*p);
+        if (chain && chains.steps > 0) chain->add(chains.perm());
+    }
+
+    // the order is only a lower bound if a chain is not complete
+    vector<uint32_t> order(1, 1);
+    stats.log10_order = 0;
+    for (const auto& chain : chains.getChains()) {
+        if (!chain) continue;
+        for (uint32_t lev = 0; lev < chain->nbLevels(); ++lev) {
+            multiplyDecimal(order, chain->orbitSize(lev));
+            stats.log10_order += std::log10((double)chain->orbitSize(lev));
+        }
+    }
+    stats.order = chains.steps > 0 ? decimalToString(order) : string();
+
+    std::map<uint32_t, uint32_t> size;
+    for (uint32_t i = 0; i < chains.nbPoints(); ++i) {
+        size[orbits.find(i)]++;
+    }
+    std::map<uint32_t, uint32_t> nbOfSize;
+    for (const auto& s : size) {
+        nbOfSize[s.second]++;
+    }
+    stats.nb_orbits = size.size();
+    stats.max_orbit = nbOfSize.empty() ? 0 : nbOfSize.rbegin()->first;
+    stats.orbit_sizes.assign(nbOfSize.cbegin(), nbOfSize.cend());
+}
+
 void Group::maximallyExtend(shared_ptr<Matrix> matrix, uint32_t indexOfFirstNewRow)
 {
     for (uint32_t i = indexOfFirstNewRow; i < matrix->nbRows(); ++i) {
@@ -705,25 +1269,36 @@ void Group::addBinaryClausesTo(Breaker& brkr, vector<BLit>& out_order,
         // 0) a non-excluded variable
         // 1) in _a_ largest orbit with non-excluded variables
         // 2) has the lowest occurrence of literals adhering to 0) and 1)
+        // unless the caller gave priorities, which then come before 1)
         vector<shared_ptr<vector<BLit> > > orbs;
         AlgebraicAlgos::getOrbits2(perms, orbs);
         std::unordered_map<BLit, uint32_t> lits2occ;
         AlgebraicAlgos::getPosLitOccurrenceCount(perms, lits2occ);
 
+        const bool prioritized = !conf->varPriority.empty();
         shared_ptr<vector<BLit> > finalOrb(new vector<BLit>());
         BLit finalLit = BLit_Undef;
         uint32_t finalOccurrence = std::numeric_limits<uint32_t>::max();
         for (auto o : orbs) {
             // check whether o is bigger
-            if (o->size() < finalOrb->size()) {
+            if (!prioritized && o->size() < finalOrb->size()) {
                 // note the strict inequality above (see condition 1)
                 continue;
             }
             // check whether o contains a positive non-excluded lit
             for (auto l : *o) {
-                if (excludedLits.count(l) == 0 &&
-                    lits2occ.count(l) > 0 &&
-                    lits2occ[l] < finalOccurrence) {
+                if (excludedLits.count(l) > 0 || lits2occ.count(l) == 0) {
+                    continue;
+                }
+                bool better = lits2occ[l] < finalOccurrence;
+                if (prioritized && finalLit != BLit_Undef) {
+                    if (getPriority(l) != getPriority(finalLit)) {
+                        better = getPriority(l) > getPriority(finalLit);
+                    } else if (o->size() != finalOrb->size()) {
+                        better = o->size() > finalOrb->size();
+                    }
+                }
+                if (better) {
                     // success!
                     finalLit = l;
                     finalOccurrence = lits2occ[l];
@@ -758,6 +1333,14 @@ void Group::addBinaryClausesTo(Breaker& brkr, vector<BLit>& out_order,
     }
 }
 
+double Group::getPriority(BLit lit) const
+{
+    if (lit.var() >= conf->varPriority.size()) {
+        return 0;
+    }
+    return conf->varPriority[lit.var()];
+}
+
 ///The order is a list of literals, such that for each literal l, neg(l) is not in the order
 void Group::getOrderAndAddBinaryClausesTo(Breaker& brkr,
                                           vector<BLit>& out_order)
@@ -798,10 +1381,15 @@ void Group::getOrderAndAddBinaryClausesTo(Breaker& brkr,
             occ2lit.insert({it.second, it.first});
         }
     }
-    // lastly, add those sorted lits to the order
+    // lastly, add those sorted lits to the order, by priority first if any
+    const size_t firstSorted = out_order.size();
     for (auto it : occ2lit) {
         out_order.push_back(it.second);
     }
+    if (!conf->varPriority.empty()) {
+        std::stable_sort(out_order.begin() + firstSorted, out_order.end(),
+            [&](BLit a, BLit b) { return getPriority(a) > getPriority(b); });
+    }
 
     ///////////
     // ok, all that is left is to add the matrix lits
@@ -841,15 +1429,138 @@ void Group::addBreakingClausesTo(Breaker& brkr)
     }
 
     // add clauses based on detected matrices
+    addDoubleLexClausesTo(brkr, order);
+}
+
+void Group::addDoubleLexClausesTo(Breaker& brkr, const vector<BLit>& order)
+{
+    std::unordered_map<BLit, uint32_t> positions;
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        positions.insert({order[i], i});
+    }
+    vector<vector<std::pair<BLit, BLit> > > chains;
+    getRowSwapChains(positions, chains);
+    for (const auto& chain : chains) {
+        brkr.addLexLeq(chain);
+    }
+}
+
+///The chain of a row swap is that of the permutation swapping the rows,
+///built from the rows instead: the swap is a product of 2-cycles, each
+///giving a step at the first of its literals in the order, so it takes
+///time linear in the rows instead of in the order
+void Group::getRowSwapChains(const std::unordered_map<BLit, uint32_t>& positions,
+                             vector<vector<std::pair<BLit, BLit> > >& out)
+{
+    auto position = [&](BLit l) {
+        auto it = positions.find(l);
+        return (it == positions.end()) ? noPoint : it->second;
+    };
+
+    vector<std::pair<uint32_t, std::pair<BLit, BLit> > > steps;
     for (auto m : matrices) {
-        for (uint32_t idx = 0; idx < m->nbRows() - 1; ++idx) {
-            shared_ptr<Permutation> rowswap(
-                new Permutation(*m->getRow(idx), *m->getRow(idx + 1), conf));
-            brkr.addSym(rowswap, order, false);
+        for (uint32_t idx = 0; idx + 1 < m->nbRows(); ++idx) {
+            const vector<BLit>& row1 = *m->getRow(idx);
+            const vector<BLit>& row2 = *m->getRow(idx + 1);
+            steps.clear();
+            for (uint32_t i = 0; i < row1.size() && i < row2.size(); ++i) {
+                const BLit a = row1[i];
+                const BLit b = row2[i];
+                const uint32_t posA = position(a);
+                const uint32_t posB = position(b);
+                if (b == ~a) {
+                    // the chain ends here, on either side
+                    if (posA != noPoint) steps.push_back({posA, {a, b}});
+                    if (posB != noPoint) steps.push_back({posB, {b, a}});
+                } else if (a != b && posA != noPoint && posB != noPoint) {
+                    if (posA < posB) {
+                        steps.push_back({posA, {a, b}});
+                    } else {
+                        steps.push_back({posB, {b, a}});
+                    }
+                }
+            }
+            std::sort(steps.begin(), steps.end(),
+                [](const std::pair<uint32_t, std::pair<BLit, BLit> >& x,
+                   const std::pair<uint32_t, std::pair<BLit, BLit> >& y) {
+                    return x.first < y.first;
+                });
+
+            out.emplace_back();
+            vector<std::pair<BLit, BLit> >& chain = out.back();
+            for (const auto& step : steps) {
+                chain.push_back(step.second);
+                if (step.second.second == ~step.second.first) {
+                    break;
+                }
+            }
         }
     }
 }
 
+void Group::addBreakingCandidatesTo(vector<BLit>& order, uint32_t rank,
+                                    vector<BreakingCandidate>& out)
+{
+    std::unordered_map<BLit, uint32_t> positions;
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        positions.insert({order[i], i});
+    }
+
+    vector<shared_ptr<Permutation> > gens;
+    const uint32_t nbRowSwaps = getGenerators(gens);
+    vector<vector<std::pair<BLit, BLit> > > rowChains;
+    getRowSwapChains(positions, rowChains);
+    assert(rowChains.size() == nbRowSwaps);
+    vector<shared_ptr<vector<BLit> > > orbits;
+    AlgebraicAlgos::getOrbits2(gens, orbits);
+    std::unordered_map<BLit, uint32_t> orbitSizes;
+    for (auto& o : orbits) {
+        for (auto l : *o) {
+            orbitSizes[l] = o->size();
+        }
+    }
+
+    for (uint32_t i = 0; i < gens.size(); ++i) {
+        BreakingCandidate cand;
+        cand.perm = gens[i];
+        cand.order = &order;
+        if (i < nbRowSwaps) {
+            cand.rowSwap = true;
+            cand.rowChain = std::move(rowChains[i]);
+        }
+        cand.firstMoved = order.size();
+        for (auto l : gens[i]->domain) {
+            auto it = positions.find(l);
+            if (it != positions.end() && it->second < cand.firstMoved) {
+                cand.firstMoved = it->second;
+            }
+        }
+        cand.orbitSize = 1;
+        if (cand.firstMoved < order.size()) {
+            auto it = orbitSizes.find(order[cand.firstMoved]);
+            if (it != orbitSizes.end()) {
+                cand.orbitSize = it->second;
+            }
+        }
+        cand.supportSize = gens[i]->supportSize();
+        cand.rank = rank;
+        out.push_back(cand);
+    }
+}
+
+uint32_t Group::getMaxOrbitSize()
+{
+    vector<shared_ptr<Permutation> > gens;
+    getGenerators(gens);
+    vector<shared_ptr<vector<BLit> > > orbits;
+    AlgebraicAlgos::getOrbits2(gens, orbits);
+    uint32_t maxSize = 0;
+    for (auto& o : orbits) {
+        maxSize = std::max<uint32_t>(maxSize, o->size());
+    }
+    return maxSize;
+}
+
 // =================MATRIX======================
 
 Matrix::Matrix(Config* _conf) :
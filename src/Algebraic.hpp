@@ -72,6 +72,7 @@ public:
 
     void addFromTo(BLit from, BLit to);
     void addCycle(vector<BLit>& cyc);
+    void addCycle(const BLit* cyc, size_t n);
     void addPrimeSplitToVector(vector<shared_ptr<Permutation> >& newPerms);
     const std::unordered_map<BLit, BLit>& getPerm();
 
@@ -120,11 +121,35 @@ class Matrix
                                             uint32_t r2); // return p*swap(r1,r2)
 };
 
+///A generator whose lex-leader chain may be added to the breaking formula,
+///see Group::addBreakingCandidatesTo()
+struct BreakingCandidate {
+    shared_ptr<Permutation> perm;
+    vector<BLit>* order; ///<order of its subgroup
+    bool rowSwap = false; ///<a swap of consecutive rows of a matrix
+    vector<std::pair<BLit, BLit> > rowChain; ///<its chain, if rowSwap, see Group::getRowSwapChains()
+    uint32_t firstMoved; ///<position in order of the first literal moved
+    uint32_t orbitSize; ///<size of the orbit of that literal
+    uint32_t supportSize;
+    uint32_t rank; ///<rank of its subgroup
+
+    ///Whether it is expected to break more per clause: its chain starts
+    ///earlier in the order, in a larger orbit, and is shorter
+    bool operator<(const BreakingCandidate& other) const
+    {
+        if (firstMoved != other.firstMoved) return firstMoved < other.firstMoved;
+        if (orbitSize != other.orbitSize) return orbitSize > other.orbitSize;
+        if (supportSize != other.supportSize) return supportSize < other.supportSize;
+        return rank < other.rank;
+    }
+};
+
 class Group
 {
 public:
     OnlCNF* theory = NULL;
     void get_perms_to(vector<std::unordered_map<BLit, BLit>>& out);
+    void visitPermutations(const BID::PermVisitor& visitor) const;
 
     Group(Config* conf);
     ~Group();
@@ -148,7 +173,9 @@ public:
     bool permutes(BLit lit);
     uint32_t getSupportSize();
 
-    ///returns a vector containing a lit for literals relevant to construct sym breaking clauses
+    ///returns a vector containing a lit for literals relevant to construct sym breaking clauses,
+    ///the matrix literals last, row by row; the others follow the variable
+    ///priorities of the config, if any, as far as the stabilizers allow
     void getOrderAndAddBinaryClausesTo(
         Breaker& brkr,
         vector<BLit>& out_order
@@ -158,6 +185,33 @@ public:
                             const std::unordered_set<BLit>& excludedLits);
     void addBreakingClausesTo(Breaker& brkr);
 
+    ///lex-leader constraints of the swaps of consecutive rows of the
+    ///matrices, which with the matrices of checkColumnInterchangeability()
+    ///order both the rows and the columns: double-lex
+    void addDoubleLexClausesTo(Breaker& brkr, const vector<BLit>& order);
+
+    ///the lex-leader chains of those row swaps, built from the rows, in
+    ///the order of getGenerators(); positions maps a literal to its
+    ///position in the order
+    void getRowSwapChains(const std::unordered_map<BLit, uint32_t>& positions,
+                          vector<vector<std::pair<BLit, BLit> > >& out);
+
+    ///the permutations and the matrix row swaps, as candidates for
+    ///breaking with the given order of this group
+    void addBreakingCandidatesTo(vector<BLit>& order, uint32_t rank,
+                                 vector<BreakingCandidate>& out);
+
+    ///size of the largest orbit of the literals
+    uint32_t getMaxOrbitSize();
+
+    ///remove the permutations that are in the group generated by the
+    ///matrices and the permutations before them, returns how many
+    uint32_t removeRedundantGenerators();
+
+    ///order, orbits and longest cycle of the group generated by the
+    ///permutations and the matrices
+    void getStats(BID::SubgroupStats& stats);
+
     void maximallyExtend(shared_ptr<Matrix> matrix, uint32_t indexOfFirstNewRow);
 
 private:
@@ -167,6 +221,13 @@ private:
 
     ///remove permutations implied by the matrix
     void cleanPermutations(shared_ptr<Matrix> matrix);
+
+    ///priority of the variable of lit given by the caller, 0 if none
+    double getPriority(BLit lit) const;
+
+    ///the swaps of consecutive matrix rows, then the permutations,
+    ///returns the number of row swaps
+    uint32_t getGenerators(vector<shared_ptr<Permutation> >& out);
     Config* conf;
 };
 
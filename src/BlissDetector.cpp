@@ -0,0 +1,354 @@
+/******************************************
+Copyright (c) 2024 Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "BlissDetector.hpp"
+#include "bliss/graph.hh"
+#include "config.hpp"
+
+using std::cout;
+using std::endl;
+using std::vector;
+
+static bool callProgress(
+    const Config* conf, const bliss::Stats& stats, double elapsed)
+{
+    BID::SearchProgress prog;
+    prog.nodes = stats.get_nof_nodes();
+    prog.generators = stats.get_nof_generators();
+    prog.steps_remain = stats.max_num_steps;
+    prog.elapsed_time = elapsed;
+    return conf->progress_cb(prog);
+}
+
+///Called by BLISS every conf->progress_period search nodes,
+///returning false stops the search
+static bool blissProgress(
+    void* param, const bliss::Stats& stats, double elapsed)
+{
+    const Config* conf = (const Config*)param;
+    return callProgress(conf, stats, elapsed);
+}
+
+///This method is given to BLISS as a polymorphic consumer
+///of the detected generator permutations
+static void addBlissPermutation(
+    void* param, const unsigned int n,
+    const unsigned int* aut)
+{
+    GeneratorSink* sink = (GeneratorSink*)param;
+    sink->add_generator(n, aut);
+}
+
+BlissDetector::BlissDetector(Config* _conf, uint32_t nb_vertices) :
+    conf(_conf)
+    , g(new bliss::Graph(nb_vertices))
+{
+    //DEBUG speed
+    /*g->set_verbose_level(2);
+    g->set_verbose_file(stdout);*/
+}
+
+BlissDetector::~BlissDetector()
+{
+    delete g;
+}
+
+uint32_t BlissDetector::add_vertex(uint32_t color)
+{
+    return g->add_vertex(color);
+}
+
+void BlissDetector::add_edge(uint32_t v1, uint32_t v2)
+{
+    g->add_edge(v1, v2);
+}
+
+void BlissDetector::reserve_vertices(uint32_t nb_new_vertices)
+{
+    g->reserve_vertices(nb_new_vertices);
+}
+
+void BlissDetector::reserve_edges(uint32_t v, uint32_t degree)
+{
+    g->reserve_edges(v, degree);
+}
+
+void BlissDetector::change_color(uint32_t v, uint32_t color)
+{
+    g->change_color(v, color);
+}
+
+uint32_t BlissDetector::nb_vertices() const
+{
+    return g->get_nof_vertices();
+}
+
+bool BlissDetector::initial_partition_stats(
+    uint32_t& nb_cells
+    , uint32_t& nb_singletons
+    , uint32_t& max_cell_size
+) {
+    g->initial_partition_stats(nb_cells, nb_singletons, max_cell_size);
+    return true;
+}
+
+bool BlissDetector::equitable_cells(vector<uint32_t>& cell_of)
+{
+    g->initial_partition_cells(cell_of);
+    return true;
+}
+
+bool BlissDetector::group_size(long double& size) const
+{
+    size = last_group_size;
+    return last_group_size > 0;
+}
+
+void BlissDetector::configure()
+{
+    g->set_splitting_heuristic(
+        (bliss::Graph::SplittingHeuristic)conf->splitHeuristic);
+    if (conf->progress_cb) {
+        g->set_progress_hook(&blissProgress, (void*)conf, conf->progress_period);
+    } else {
+        g->set_progress_hook(NULL, NULL, 0);
+    }
+}
+
+bool BlissDetector::find_generators(
+    GeneratorSink& sink
+    , int64_t steps_lim
+    , int64_t* out_steps_lim
+) {
+    if (conf->usePortfolio && !conf->portfolioDone) {
+        // race once, later searches (stabilizers, subgroups) use the winner
+        conf->portfolioDone = true;
+        return raceSplitHeuristics(sink, steps_lim, out_steps_lim);
+    }
+
+    bliss::Stats stats;
+    stats.max_num_steps = steps_lim;
+    configure();
+    if (conf->searchThreads > 1) {
+        g->find_automorphisms_parallel(
+            stats, &addBlissPermutation, (void*)&sink, conf->searchThreads);
+    } else {
+        g->find_automorphisms(stats, &addBlissPermutation, (void*)&sink);
+    }
+    last_group_size = stats.get_group_size_approx();
+    if (out_steps_lim) {
+        *out_steps_lim = stats.max_num_steps;
+    }
+    return g->last_search_complete();
+}
+
+///One of the searches racing in portfolio mode, on its own copy of the graph
+struct PortfolioRun {
+    const Config* conf;
+    bliss::Graph* g = NULL;
+    ///automorphisms found, as the list of moved points
+    vector<vector<std::pair<uint32_t, uint32_t> > > auts;
+    int64_t steps_remain = 0;
+    long double group_size = 0;
+    bool complete = false;
+    uint32_t cb_countdown = 0;
+    uint32_t cb_every = 0;
+    std::atomic<bool>* stop;
+    std::mutex* cb_mutex;
+};
+
+static void addPortfolioPermutation(
+    void* param, const unsigned int n,
+    const unsigned int* aut)
+{
+    PortfolioRun* r = (PortfolioRun*)param;
+    r->auts.push_back(vector<std::pair<uint32_t, uint32_t> >());
+    for (unsigned i = 0; i < n; ++i) {
+        if (i != aut[i]) {
+            r->auts.back().push_back(std::make_pair(i, aut[i]));
+        }
+    }
+}
+
+///Stops the losers of the race, and forwards to the user's progress
+///callback, one thread at a time
+static bool portfolioProgress(
+    void* param, const bliss::Stats& stats, double elapsed)
+{
+    PortfolioRun* r = (PortfolioRun*)param;
+    if (r->stop->load(std::memory_order_relaxed)) {
+        return false;
+    }
+    if (r->conf->progress_cb && --r->cb_countdown == 0) {
+        r->cb_countdown = r->cb_every;
+        std::lock_guard<std::mutex> lock(*r->cb_mutex);
+        if (!callProgress(r->conf, stats, elapsed)) {
+            *r->stop = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BlissDetector::raceSplitHeuristics(
+    GeneratorSink& sink
+    , int64_t steps_lim
+    , int64_t* out_steps_lim
+) {
+    const uint32_t n = g->get_nof_vertices();
+    vector<unsigned int> identity(n);
+    std::iota(identity.begin(), identity.end(), 0);
+
+    // race as many heuristics as there are cores, the current one first
+    vector<uint32_t> heurs;
+    heurs.push_back((uint32_t)conf->splitHeuristic);
+    for (uint32_t i = 0; i < BID::nb_split_heuristics; i++) {
+        if (i != heurs[0]) heurs.push_back(i);
+    }
+    const uint32_t cores = std::thread::hardware_concurrency();
+    if (cores > 0 && cores < heurs.size()) {
+        heurs.resize(cores);
+    }
+
+    // the losers check for cancellation at this period
+    const uint32_t period = std::min<uint32_t>(64, conf->progress_period);
+    std::atomic<bool> stop(false);
+    std::atomic<int> winner(-1);
+    std::mutex cb_mutex;
+    vector<PortfolioRun> runs(heurs.size());
+    vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    double win_time = 0;
+    for (uint32_t i = 0; i < runs.size(); i++) {
+        PortfolioRun& r = runs[i];
+        r.conf = conf;
+        r.g = g->permute(identity.data());
+        r.g->set_splitting_heuristic((bliss::Graph::SplittingHeuristic)heurs[i]);
+        r.g->set_progress_hook(&portfolioProgress, (void*)&r, period);
+        r.cb_every = std::max<uint32_t>(1, conf->progress_period/period);
+        r.cb_countdown = r.cb_every;
+        r.stop = &stop;
+        r.cb_mutex = &cb_mutex;
+        threads.push_back(std::thread([&, i]() {
+            PortfolioRun& me = runs[i];
+            bliss::Stats stats;
+            stats.max_num_steps = steps_lim;
+            me.g->find_automorphisms(stats, &addPortfolioPermutation, (void*)&me);
+            me.steps_remain = stats.max_num_steps;
+            me.group_size = stats.get_group_size_approx();
+            me.complete = me.g->last_search_complete();
+
+            int none = -1;
+            if (me.complete && winner.compare_exchange_strong(none, (int)i)) {
+                stop = true;
+                win_time = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count();
+            }
+        }));
+    }
+    for (auto& t: threads) {
+        t.join();
+    }
+
+    // if no search completed, keep the (partial) result of the current heuristic
+    const bool found = winner >= 0;
+    const uint32_t w = found ? winner.load() : 0;
+    conf->splitHeuristic = (BID::SplitHeuristic)heurs[w];
+    g->set_splitting_heuristic((bliss::Graph::SplittingHeuristic)heurs[w]);
+    if (conf->verbosity) {
+        if (found) {
+            cout << "c [portfolio] splitting heuristic "
+            << BID::to_string(conf->splitHeuristic)
+            << " finished first of " << runs.size()
+            << ", T: " << win_time << endl;
+        } else {
+            cout << "c [portfolio] no splitting heuristic finished, using "
+            << BID::to_string(conf->splitHeuristic) << endl;
+        }
+    }
+
+    for (const auto& aut: runs[w].auts) {
+        for (const auto& p: aut) {
+            identity[p.first] = p.second;
+        }
+        sink.add_generator(n, identity.data());
+        for (const auto& p: aut) {
+            identity[p.first] = p.first;
+        }
+    }
+    last_group_size = runs[w].group_size;
+    if (out_steps_lim) {
+        *out_steps_lim = runs[w].steps_remain;
+    }
+    for (auto& r: runs) {
+        delete r.g;
+    }
+    return runs[w].complete;
+}
+
+RandomDetector::RandomDetector(Config* _conf, uint32_t nb_vertices) :
+    BlissDetector(_conf, nb_vertices)
+{
+}
+
+bool RandomDetector::find_generators(
+    GeneratorSink& sink
+    , int64_t steps_lim
+    , int64_t* out_steps_lim
+) {
+    bliss::Stats stats;
+    stats.max_num_steps = steps_lim;
+    configure();
+    g->find_automorphisms_randomized(
+        stats, &addBlissPermutation, (void*)&sink, conf->randomizedFails);
+    last_group_size = stats.get_group_size_approx();
+    if (out_steps_lim) {
+        *out_steps_lim = stats.max_num_steps;
+    }
+    return g->last_search_complete();
+}
+
+RefineDetector::RefineDetector(Config* _conf, uint32_t nb_vertices) :
+    BlissDetector(_conf, nb_vertices)
+{
+}
+
+bool RefineDetector::find_generators(
+    GeneratorSink&
+    , int64_t steps_lim
+    , int64_t* out_steps_lim
+) {
+    if (out_steps_lim) {
+        *out_steps_lim = steps_lim;
+    }
+    return true;
+}
@@ -0,0 +1,109 @@
+/******************************************
+Copyright (c) 2024 Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef BREAKID_BLISS_DETECTOR_H
+#define BREAKID_BLISS_DETECTOR_H
+
+#include "SymmetryDetector.hpp"
+
+namespace bliss {
+class Graph;
+}
+
+///The exhaustive search of bliss, on conf->searchThreads threads, or
+///racing the splitting heuristics if conf->usePortfolio is set
+class BlissDetector : public SymmetryDetector
+{
+public:
+    BlissDetector(Config* conf, uint32_t nb_vertices);
+    ~BlissDetector() override;
+    const char* name() const override { return "bliss"; }
+
+    uint32_t add_vertex(uint32_t color) override;
+    void add_edge(uint32_t v1, uint32_t v2) override;
+    void change_color(uint32_t v, uint32_t color) override;
+    uint32_t nb_vertices() const override;
+    void reserve_vertices(uint32_t nb_new_vertices) override;
+    void reserve_edges(uint32_t v, uint32_t degree) override;
+
+    bool find_generators(
+        GeneratorSink& sink
+        , int64_t steps_lim
+        , int64_t* out_steps_lim
+    ) override;
+    bool initial_partition_stats(
+        uint32_t& nb_cells
+        , uint32_t& nb_singletons
+        , uint32_t& max_cell_size
+    ) override;
+    bool equitable_cells(std::vector<uint32_t>& cell_of) override;
+    bool group_size(long double& size) const override;
+
+protected:
+    ///Sets the splitting heuristic and the progress hook from conf
+    void configure();
+
+    Config* conf;
+    bliss::Graph* g;
+    ///of the last search, 0 before the first one
+    long double last_group_size = 0;
+
+private:
+    bool raceSplitHeuristics(
+        GeneratorSink& sink
+        , int64_t steps_lim
+        , int64_t* out_steps_lim
+    );
+};
+
+///The randomized search of bliss::Graph::find_automorphisms_randomized(),
+///stopping after conf->randomizedFails random automorphisms already found
+class RandomDetector : public BlissDetector
+{
+public:
+    RandomDetector(Config* conf, uint32_t nb_vertices);
+    const char* name() const override { return "random"; }
+
+    bool find_generators(
+        GeneratorSink& sink
+        , int64_t steps_lim
+        , int64_t* out_steps_lim
+    ) override;
+};
+
+///Runs no search: finds no generators, and only answers equitable_cells(),
+///as a quick estimate of the orbits
+class RefineDetector : public BlissDetector
+{
+public:
+    RefineDetector(Config* conf, uint32_t nb_vertices);
+    const char* name() const override { return "refine"; }
+
+    bool find_generators(
+        GeneratorSink& sink
+        , int64_t steps_lim
+        , int64_t* out_steps_lim
+    ) override;
+};
+
+#endif
@@ -61,6 +61,13 @@ vector<vector<BID::BLit>> Breaker::get_brk_cls()
     return cls;
 }
 
+void Breaker::visitClauses(const BID::LitsVisitor& visitor) const
+{
+    for (const auto& cl: clauses) {
+        visitor(cl->lits.data(), cl->lits.size());
+    }
+}
+
 void Breaker::add(shared_ptr<Clause> cl)
 {
     clauses.insert(cl);
@@ -93,8 +100,26 @@ void Breaker::addQuaternary(BLit l1, BLit l2, BLit l3, BLit l4)
     add(toAdd);
 }
 
+bool Breaker::fitsBudget(uint32_t nbClauses, uint32_t nbAuxVars) const
+{
+    if (conf->breakingClauseBudget > -1
+        && clauses.size() + nbClauses > (uint64_t)conf->breakingClauseBudget
+    ) {
+        return false;
+    }
+    if (conf->breakingAuxBudget > -1
+        && nbExtraVars + nbAuxVars > (uint64_t)conf->breakingAuxBudget
+    ) {
+        return false;
+    }
+    return true;
+}
+
 void Breaker::addBinClause(BLit l1, BLit l2)
 {
+    if (!fitsBudget(1, 0)) {
+        return;
+    }
     ++nbBinClauses;
     addBinary(l1, l2);
 }
@@ -105,17 +130,30 @@ void Breaker::addSym(
     , bool limitExtraConstrs
 ) {
     uint32_t current = getTotalNbClauses();
+    vector<std::pair<BLit, BLit> > chain;
+    getChain(perm, order, limitExtraConstrs, chain);
+    addChain(chain);
+    nbRegClauses += getTotalNbClauses() - current;
+}
+
+void Breaker::addLexLeq(const vector<std::pair<BLit, BLit> >& chain)
+{
+    uint32_t current = getTotalNbClauses();
+    addChain(chain);
+    nbRowClauses += getTotalNbClauses() - current;
+}
+
+void Breaker::addChain(const vector<std::pair<BLit, BLit> >& chain)
+{
     if (conf->useShatterTranslation) {
-        assert(false);
-        addShatter(perm, order, limitExtraConstrs);
+        addShatter(chain);
     } else {
-        addBreakID(perm, order, limitExtraConstrs);
+        addBreakID(chain);
     }
-    nbRegClauses += getTotalNbClauses() - current;
 }
 
-void Breaker::addBreakID(shared_ptr<Permutation> perm, std::vector<BLit>& order,
-                  bool limitExtraConstrs)
+void Breaker::getChain(shared_ptr<Permutation> perm, const vector<BLit>& order,
+                       bool limitExtraConstrs, vector<std::pair<BLit, BLit> >& chain)
 {
     /// which are not the last lit in their cycle, unless they map to their negation
     std::unordered_set<BLit> allowedLits;
@@ -134,44 +172,68 @@ void Breaker::addBreakID(shared_ptr<Permutation> perm, std::vector<BLit>& order,
         }
     }
 
+    for (auto l : order) {
+        if (limitExtraConstrs && (int)chain.size() > conf->symBreakingFormLength) {
+            break;
+        }
+        BLit sym = perm->getImage(l);
+        if (sym != l && allowedLits.count(l)) {
+            chain.push_back({l, sym});
+            if (sym == ~l) {
+                break;
+            }
+        }
+    }
+}
+
+void Breaker::addBreakID(const vector<std::pair<BLit, BLit> >& chain)
+{
     int nrExtraConstrs = 0;
     BLit prevLit = BLit_Undef;
     BLit prevSym = BLit_Undef;
     BLit prevTst = BLit_Undef; // previous tseitin
-    for (auto l : order) {
-        if (limitExtraConstrs && nrExtraConstrs > conf->symBreakingFormLength) {
+    for (const auto& step : chain) {
+        const BLit l = step.first;
+        const BLit sym = step.second;
+        // a prefix of the chain still breaks the symmetry, so the chain
+        // stops where the budget runs out
+        const uint32_t nbNewAux = (nrExtraConstrs == 0) ? 0 : 1;
+        const uint32_t nbNewClauses = (nrExtraConstrs == 0) ? 1
+            : (conf->useFullTranslation ? 5 : 3);
+        if (!fitsBudget(nbNewClauses, nbNewAux)) {
             break;
         }
-        BLit sym = perm->getImage(l);
-        if (sym != l && allowedLits.count(l)) {
-            BLit tst = BLit_Undef;
-            if (nrExtraConstrs == 0) {
-                // adding clause for l => sym :
-                // ~l | sym
-                addBinary(~l, sym);
-            } else if (nrExtraConstrs == 1) {
-                // adding clauses for (prevSym => prevLit) => tst and tst => (l => sym)
-                tst = getTseitinVar();
+        BLit tst = BLit_Undef;
+        if (nrExtraConstrs == 0) {
+            // adding clause for l => sym :
+            // ~l | sym
+            addBinary(~l, sym);
+        } else if (nrExtraConstrs == 1) {
+            // adding clauses for (prevSym => prevLit) => tst and tst => (l => sym)
+            bool fresh;
+            tst = getPrefixVar(BLit_Undef, prevLit, prevSym, fresh);
+            if (fresh) {
                 // prevSym | tst
                 addBinary(prevSym, tst);
                 // ~prevLit | tst
                 addBinary(~prevLit, tst);
-                // ~tst | ~l | sym
-                addTernary(~tst, ~l, sym);
                 if (conf->useFullTranslation) {
                     // adding clauses for tst => (prevSym => prevLit)
                     // ~tst | ~prevSym | prevLit
                     addTernary(~tst, ~prevSym, prevLit);
                 }
-            } else {
-                // adding clauses for (prevSym => prevLit) & prevTst => tst and tst => (l => sym)
-                tst = getTseitinVar();
+            }
+            // ~tst | ~l | sym
+            addTernary(~tst, ~l, sym);
+        } else {
+            // adding clauses for (prevSym => prevLit) & prevTst => tst and tst => (l => sym)
+            bool fresh;
+            tst = getPrefixVar(prevTst, prevLit, prevSym, fresh);
+            if (fresh) {
                 // prevSym | ~prevTst | tst
                 addTernary(prevSym, ~prevTst, tst);
                 // ~prevLit | ~prevTst | tst
                 addTernary(~prevLit, ~prevTst, tst);
-                // ~tst | ~l | sym
-                addTernary(~tst, ~l, sym);
                 if (conf->useFullTranslation) {
                     // adding clauses for tst => prevTst and tst => (prevSym => prevLit)
                     // ~tst | prevTst
@@ -180,83 +242,77 @@ void Breaker::addBreakID(shared_ptr<Permutation> perm, std::vector<BLit>& order,
                     addTernary(~tst, ~prevSym, prevLit);
                 }
             }
-            ++nrExtraConstrs;
-            if (sym == ~l) {
-                break;
-            }
-
-            prevLit = l;
-            prevSym = sym;
-            prevTst = tst;
+            // ~tst | ~l | sym
+            addTernary(~tst, ~l, sym);
         }
+        ++nrExtraConstrs;
+
+        prevLit = l;
+        prevSym = sym;
+        prevTst = tst;
     }
 }
 
-void Breaker::addShatter(shared_ptr<Permutation> perm, std::vector<BLit>& order,
-                         bool limitExtraConstrs)
+void Breaker::addShatter(const vector<std::pair<BLit, BLit> >& chain)
 {
-    // which are not the last lit in their cycle, unless they map to their negation
-    std::unordered_set<BLit> allowedLits;
-
-    for (uint32_t i = order.size(); i > 0; --i) {
-        BLit lit = order.at(i - 1);
-        if (allowedLits.count(lit) == 0) { // we have a last lit of a cycle
-            BLit sym = perm->getImage(lit);
-
-            // add the other lits of the cycle and the negated cycle
-            while (sym != lit) {
-                allowedLits.insert(sym);
-                allowedLits.insert(~sym);
-                sym = perm->getImage(sym);
-            }
-        }
-    }
-
+    // Shatter's encoding: with e the literals of the chain and E(k) the
+    // equality of e(0..k) and their images, add E(k-1) => (e(k) => sym(e(k))).
+    // E(k-1) is split on e(k-1) being true, hence its image too, or its
+    // image being false, hence e(k-1) too, and the rest of it is the Tseitin
+    // variable of E(k-2), only introduced once the chain needs it
     int nrExtraConstrs = 0;
     BLit prevLit = BLit_Undef;
     BLit prevSym = BLit_Undef;
-    BLit prevTst = BLit_Undef; // previous tseitin
-    for (auto l : order) {
-        if (limitExtraConstrs && nrExtraConstrs > conf->symBreakingFormLength) {
+    BLit prevPrevLit = BLit_Undef;
+    BLit prevPrevSym = BLit_Undef;
+    BLit prevTst = BLit_Undef; // tseitin of E(k-3)
+    BLit tst = BLit_Undef; // tseitin of E(k-2)
+    for (const auto& step : chain) {
+        const BLit l = step.first;
+        const BLit sym = step.second;
+        const uint32_t nbNewAux = (nrExtraConstrs < 2) ? 0 : 1;
+        const uint32_t nbNewClauses = (nrExtraConstrs == 0) ? 1
+            : (nrExtraConstrs == 1 ? 2 : 4);
+        if (!fitsBudget(nbNewClauses, nbNewAux)) {
             break;
         }
-        BLit sym = perm->getImage(l);
-        if (sym != l && allowedLits.count(l)) {
-            BLit tst = BLit_Undef;
-            if (nrExtraConstrs == 0) {
-                // adding clause for l => sym :
-                // ~l | sym
-                addBinary(~l, sym);
-            } else if (nrExtraConstrs == 1) {
-                tst = getTseitinVar();
-                // clause(-z, -x, p[x], 0);
-                addTernary(~prevLit, ~l, sym);
-                // clause(-z, vars+1, 0);
-                addBinary(~prevLit, tst);
-                // clause(p[z], -x, p[x], 0);
-                addTernary(prevSym, ~l, sym);
-                // clause(p[z], vars+1, 0);
-                addBinary(prevSym, tst);
-            } else {
-                tst = getTseitinVar();
-                // clause(-vars, -z, -x, p[x], 0);
-                addQuaternary(~prevTst, ~prevLit, ~l, sym);
-                // clause(-vars, -z, vars+1, 0);
-                addTernary(~prevTst, ~prevLit, tst);
-                // clause(-vars, p[z], -x, p[x], 0);
-                addQuaternary(~prevTst, prevSym, ~l, sym);
-                // clause(-vars, p[z], vars+1, 0);
-                addTernary(~prevTst, prevSym, tst);
-            }
-            ++nrExtraConstrs;
-            if (sym == ~l) {
-                break;
+        if (nrExtraConstrs == 0) {
+            // adding clause for l => sym :
+            // ~l | sym
+            addBinary(~l, sym);
+        } else if (nrExtraConstrs == 1) {
+            // ~prevLit | ~l | sym
+            addTernary(~prevLit, ~l, sym);
+            // prevSym | ~l | sym
+            addTernary(prevSym, ~l, sym);
+        } else {
+            bool fresh;
+            tst = getPrefixVar(prevTst, prevPrevLit, prevPrevSym, fresh);
+            if (fresh) {
+                if (prevTst == BLit_Undef) {
+                    // ~prevPrevLit | tst
+                    addBinary(~prevPrevLit, tst);
+                    // prevPrevSym | tst
+                    addBinary(prevPrevSym, tst);
+                } else {
+                    // ~prevTst | ~prevPrevLit | tst
+                    addTernary(~prevTst, ~prevPrevLit, tst);
+                    // ~prevTst | prevPrevSym | tst
+                    addTernary(~prevTst, prevPrevSym, tst);
+                }
             }
-
-            prevLit = l;
-            prevSym = sym;
-            prevTst = tst;
+            // ~tst | ~prevLit | ~l | sym
+            addQuaternary(~tst, ~prevLit, ~l, sym);
+            // ~tst | prevSym | ~l | sym
+            addQuaternary(~tst, prevSym, ~l, sym);
         }
+        ++nrExtraConstrs;
+
+        prevPrevLit = prevLit;
+        prevPrevSym = prevSym;
+        prevLit = l;
+        prevSym = sym;
+        prevTst = tst;
     }
 }
 
@@ -295,6 +351,23 @@ uint32_t Breaker::getNbRegClauses()
     return nbRegClauses;
 }
 
+///The Tseitin variable of a prefix only depends on the prefix, so the
+///chains of the permutations that agree on it share it: the prefixes form
+///a trie, whose nodes are identified by the variable of their parent and
+///the pair leading to them
+BLit Breaker::getPrefixVar(BLit prevTst, BLit prevLit, BLit prevSym, bool& fresh)
+{
+    const ChainPrefix prefix = {prevTst, prevLit, prevSym};
+    auto it = prefixVars.find(prefix);
+    fresh = (it == prefixVars.end());
+    if (!fresh) {
+        return it->second;
+    }
+    const BLit tst = getTseitinVar();
+    prefixVars[prefix] = tst;
+    return tst;
+}
+
 BLit Breaker::getTseitinVar()
 {
     BLit ret = BLit(getTotalNbVars(), false);
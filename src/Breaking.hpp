@@ -34,6 +34,8 @@ THE SOFTWARE.
 #include <iostream>
 #include <iostream>
 #include <unordered_set>
+#include <unordered_map>
+#include <utility>
 #include "breakid.hpp"
 
 #include "config.hpp"
@@ -201,6 +203,28 @@ struct UvecEqual {
     }
 };
 
+///A prefix of a lex-leader chain: the Tseitin variable of the prefix
+///without its last (literal, image) pair, BLit_Undef if it is empty,
+///and that pair
+struct ChainPrefix {
+    BLit prevTst;
+    BLit lit;
+    BLit sym;
+
+    bool operator==(const ChainPrefix& other) const
+    {
+        return prevTst == other.prevTst && lit == other.lit && sym == other.sym;
+    }
+};
+
+struct ChainPrefixHash {
+    size_t operator()(const ChainPrefix& p) const
+    {
+        const BLit lits[3] = {p.prevTst, p.lit, p.sym};
+        return _getHash(lits, 3);
+    }
+};
+
 class Breaker
 {
 public:
@@ -216,7 +240,12 @@ public:
         , vector<BLit>& order
         , bool limitExtraConstrs
     );
+    ///Lex-leader constraint along a chain of (literal, image) pairs, in
+    ///the order, e.g. of two rows of a matrix; it ends at the first
+    ///literal whose image is its negation
+    void addLexLeq(const vector<std::pair<BLit, BLit> >& chain);
     vector<vector<BLit>> get_brk_cls();
+    void visitClauses(const BID::LitsVisitor& visitor) const;
 
     uint32_t getAuxiliaryNbVars();
     uint32_t getTotalNbVars();
@@ -236,14 +265,24 @@ private:
     uint32_t nbRowClauses = 0;
     uint32_t nbRegClauses = 0;
 
+    ///whether that many more clauses and auxiliary variables stay within
+    ///the breaking budget of the config
+    bool fitsBudget(uint32_t nbClauses, uint32_t nbAuxVars) const;
     void addBinary(BLit l1, BLit l2);
     void addTernary(BLit l1, BLit l2, BLit l3);
     void addQuaternary(BLit l1, BLit l2, BLit l3, BLit l4);
     void add(shared_ptr<Clause> cl);
-    void addBreakID(shared_ptr<Permutation> perm, vector<BLit>& order,
-             bool limitExtraConstrs);
-    void addShatter(shared_ptr<Permutation> perm, vector<BLit>& order,
-                    bool limitExtraConstrs);
+    ///the pairs of the lex-leader chain of perm, along the order
+    void getChain(shared_ptr<Permutation> perm, const vector<BLit>& order,
+                  bool limitExtraConstrs, vector<std::pair<BLit, BLit> >& chain);
+    void addChain(const vector<std::pair<BLit, BLit> >& chain);
+    void addBreakID(const vector<std::pair<BLit, BLit> >& chain);
+    void addShatter(const vector<std::pair<BLit, BLit> >& chain);
+
+    ///Tseitin variable of each prefix of the lex-leader chains, shared
+    ///by the permutations that agree on the prefix
+    std::unordered_map<ChainPrefix, BLit, ChainPrefixHash> prefixVars;
+    BLit getPrefixVar(BLit prevTst, BLit prevLit, BLit prevSym, bool& fresh);
 
     Config* conf;
 };
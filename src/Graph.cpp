@@ -22,8 +22,10 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ***********************************************/
 
+#include <cmath>
+
 #include "Graph.hpp"
-#include "bliss/graph.hh"
+#include "SymmetryDetector.hpp"
 
 using std::cout;
 using std::endl;
@@ -32,8 +34,8 @@ Graph::Graph(Config* _conf) :
     conf(_conf)
 {
     uint32_t n = 2 * conf->nVars;
-    bliss_g = new bliss::Graph(n);
-    used_lits.resize(conf->nVars*2, 0);
+    detector = new_detector(conf, n);
+    lit_occs.resize(conf->nVars*2, 0);
     neighbours.clear();
     lit2color.clear();
     nbedges = 0;
@@ -41,7 +43,6 @@ Graph::Graph(Config* _conf) :
 
     // Initialize colors
     for (uint32_t i = 0; i < 2 * conf->nVars; ++i) {
-        bliss_g->change_color(i, 0);
         vertex_to_color.push_back(0);
     }
     colorcount.push_back(2 * conf->nVars);
@@ -53,18 +54,14 @@ Graph::Graph(Config* _conf) :
     for (uint32_t l = 0; l < conf->nVars; l++) {
         uint32_t posID = BLit(l, false).toInt();
         uint32_t negID = BLit(l, true).toInt();
-        bliss_g->add_edge(posID, negID);
+        detector->add_edge(posID, negID);
         nbedges += 1;
     }
     assert(vertex_to_color.size() == n);
-    assert(bliss_g->get_nof_vertices() == n);
-
-    //DEBUG speed
-    /*bliss_g->set_verbose_level(2);
-    bliss_g->set_verbose_file(stdout);*/
+    assert(detector->nb_vertices() == n);
 }
 
-void Graph::add_clause(BID::BLit* lits, uint32_t size)
+void Graph::add_clause(const BID::BLit* lits, uint32_t size)
 {
     assert(size > 0 && "Must have clauses of size at least 1");
 
@@ -74,25 +71,54 @@ void Graph::add_clause(BID::BLit* lits, uint32_t size)
     }
 
     // Clauses have as neighbors the literals occurring in them
-    uint32_t v = bliss_g->add_vertex(1);
+    uint32_t v = detector->add_vertex(1);
+    detector->reserve_edges(v, size);
     for(size_t i = 0; i < size; i++) {
         BID::BLit l = lits[i];
-        bliss_g->add_edge(v, l.toInt());
-        used_lits[l.toInt()] = 1;
+        detector->add_edge(v, l.toInt());
+        lit_occs[l.toInt()]++;
         nbedges+=1;
     }
     assert(vertex_to_color.size() == v);
     vertex_to_color.push_back(1);
+    nbclauses++;
+}
+
+void Graph::add_clauses(const BID::BLit* lits, const uint32_t* offsets, size_t num)
+{
+    // the edges of each literal vertex are reserved once, for all its
+    // occurrences in these clauses, only the literals occurring are visited
+    batch_degrees.resize(2 * conf->nVars, 0);
+    batch_lits.clear();
+    for (uint32_t i = offsets[0]; i < offsets[num]; i++) {
+        const uint32_t l = lits[i].toInt();
+        if (batch_degrees[l]++ == 0) {
+            batch_lits.push_back(l);
+        }
+    }
+    detector->reserve_vertices(num);
+    for (const uint32_t l : batch_lits) {
+        detector->reserve_edges(l, batch_degrees[l]);
+        batch_degrees[l] = 0;
+    }
+    if (vertex_to_color.size() + num > vertex_to_color.capacity()) {
+        vertex_to_color.reserve(std::max(
+            vertex_to_color.size() + num, 2 * vertex_to_color.capacity()));
+    }
+
+    for (size_t i = 0; i < num; i++) {
+        add_clause(lits + offsets[i], offsets[i + 1] - offsets[i]);
+    }
 }
 
 void Graph::end_dynamic_cnf()
 {
-    colorcount[1] = bliss_g->get_nof_vertices() - conf->nVars*2;
+    colorcount[1] = detector->nb_vertices() - conf->nVars*2;
 
     // look for unused lits, make their color unique so that no symmetries on them are found
     // useful for subgroups
     for (uint32_t i = 0; i < 2 * conf->nVars; ++i) {
-        if (used_lits[i] == 0) {
+        if (lit_occs[i] == 0) {
             setUniqueColor(i);
         }
     }
@@ -100,29 +126,29 @@ void Graph::end_dynamic_cnf()
 
 void Graph::initializeGraph(uint32_t nbNodes)
 {
-    delete bliss_g;
-    bliss_g = new bliss::Graph(nbNodes);
+    delete detector;
+    detector = new_detector(conf, nbNodes);
     vertex_to_color.resize(nbNodes);
 
     for (size_t n = 0; n < nbNodes; n++) {
-        bliss_g->change_color(n, lit2color[n]);
+        detector->change_color(n, lit2color[n]);
         vertex_to_color[n] = lit2color[n];
     }
     for (size_t n = 0; n < nbNodes; n++) {
         for (auto other : neighbours[n]) {
-            bliss_g->add_edge(n, other);
+            detector->add_edge(n, other);
         }
     }
 }
 
 void Graph::freeGraph()
 {
-    delete (bliss_g);
+    delete detector;
 }
 
 uint32_t Graph::getNbNodesFromGraph() const
 {
-    return bliss_g->get_nof_vertices();
+    return detector->nb_vertices();
 }
 
 uint32_t Graph::getColorOf(uint32_t node) const
@@ -131,21 +157,99 @@ uint32_t Graph::getColorOf(uint32_t node) const
     return vertex_to_color[node];
 }
 
-///This method is given to BLISS as a polymorphic consumer
-///of the detected generator permutations
-static void addBlissPermutation(
-    void* param, const unsigned int n,
-    const unsigned int* aut)
-{
-    Graph* g = (Graph*)param;
+///Translates the generators of the detector to permutations of literals
+struct PermutationSink : public GeneratorSink {
+    Graph* g;
+    explicit PermutationSink(Graph* _g) : g(_g) {}
 
-    shared_ptr<Permutation> permu = std::make_shared<Permutation>(g->conf);
-    for (unsigned i = 0; i < n; ++i) {
-        if (i != aut[i]) {
-            permu->addFromTo(BLit::toBLit(i), BLit::toBLit(aut[i]));
+    void add_generator(uint32_t n, const uint32_t* aut) override
+    {
+        shared_ptr<Permutation> permu = std::make_shared<Permutation>(g->conf);
+        for (uint32_t i = 0; i < n; ++i) {
+            if (i != aut[i]) {
+                permu->addFromTo(BLit::toBLit(i), BLit::toBLit(aut[i]));
+            }
         }
+        permu->addPrimeSplitToVector(g->perms);
+    }
+};
+
+///Picks the splitting heuristic from cheap features of the graph, and
+///logs the features so that the thresholds can be recalibrated
+void Graph::chooseSplitHeuristic()
+{
+    const uint32_t nodes = detector->nb_vertices();
+    const uint32_t lit_nodes = 2*conf->nVars;
+
+    // literal degree distribution, over the literals that occur
+    uint32_t used = 0;
+    uint32_t max_deg = 0;
+    double sum = 0;
+    double sum_sq = 0;
+    for (const uint32_t d: lit_occs) {
+        if (d == 0) continue;
+        used++;
+        sum += d;
+        sum_sq += (double)d*d;
+        max_deg = std::max(max_deg, d);
+    }
+    const double mean_deg = used ? sum/used : 0;
+    const double var_deg = used ? std::max(0.0, sum_sq/used - mean_deg*mean_deg) : 0;
+    const double cv_deg = mean_deg > 0 ? std::sqrt(var_deg)/mean_deg : 0;
+    const double cls_per_lit = lit_nodes ? (double)nbclauses/lit_nodes : 0;
+
+    uint32_t cells = 0;
+    uint32_t singletons = 0;
+    uint32_t max_cell = 0;
+    const bool refined = detector->initial_partition_stats(cells, singletons, max_cell);
+    const double singleton_ratio = nodes ? (double)singletons/nodes : 1;
+
+    BID::SplitHeuristic h;
+    const char* why;
+    if (refined && singleton_ratio >= conf->autoSplitNearDiscrete) {
+        // hardly any search left, take the cheapest heuristic
+        h = BID::SplitHeuristic::f;
+        why = "nearly discrete";
+    } else if (refined && max_cell <= conf->autoSplitSmallCells) {
+        // every cell splits within a few levels whichever is chosen
+        h = BID::SplitHeuristic::f;
+        why = "small cells";
+    } else if (nodes >= conf->autoSplitLargeGraph) {
+        // the 'm' heuristics scan the neighbourhood of every cell at
+        // every node, too costly at this size
+        h = BID::SplitHeuristic::fl;
+        why = "large graph";
+    } else if (cls_per_lit >= conf->autoSplitDense) {
+        // same scan, on few but very long neighbourhood lists; the
+        // cell sizes say little once every literal touches most clauses
+        h = BID::SplitHeuristic::f;
+        why = "dense formula";
+    } else if (cv_deg >= conf->autoSplitIrregular) {
+        h = BID::SplitHeuristic::fsm;
+        why = "irregular degrees";
+    } else if (max_deg >= conf->autoSplitHub*mean_deg) {
+        // a few hub literals barely move the variation coefficient,
+        // but their cells still split unevenly
+        h = BID::SplitHeuristic::fsm;
+        why = "hub literal";
+    } else {
+        h = BID::SplitHeuristic::flm;
+        why = "default";
+    }
+    conf->splitHeuristic = h;
+
+    if (conf->verbosity) {
+        cout << "c [split] nodes: " << nodes
+        << " cls/lit: " << cls_per_lit
+        << " lit deg mean: " << mean_deg
+        << " max: " << max_deg
+        << " cv: " << cv_deg
+        << " cells: " << cells
+        << " singletons: " << singletons
+        << " max cell: " << max_cell
+        << " -> " << BID::to_string(h) << " (" << why << ")"
+        << endl;
     }
-    permu->addPrimeSplitToVector(g->perms);
 }
 
 void Graph::getSymmetryGeneratorsInternal(
@@ -153,15 +257,13 @@ void Graph::getSymmetryGeneratorsInternal(
     , int64_t steps_lim
     , int64_t* out_steps_lim
 ) {
-    bliss::Stats stats;
-    stats.max_num_steps = steps_lim;
-    //bliss_g->set_splitting_heuristic(bliss::Graph::SplittingHeuristic::shs_fl); //TODO: to decide
-
-    bliss_g->find_automorphisms(stats, &addBlissPermutation, (void*)this);
-    if (out_steps_lim) {
-        *out_steps_lim = stats.max_num_steps;
+    if (conf->autoSplitHeuristic && !conf->autoSplitDone) {
+        // also decides which heuristic goes first in a portfolio
+        conf->autoSplitDone = true;
+        chooseSplitHeuristic();
     }
-
+    PermutationSink sink(this);
+    detector->find_generators(sink, steps_lim, out_steps_lim);
     std::swap(out_perms, perms);
 }
 
@@ -186,7 +288,7 @@ void Graph::setUniqueColor(uint32_t lit)
 
     colorcount[mycolor]--;
     uint32_t new_color = colorcount.size();
-    bliss_g->change_color(lit, new_color);
+    detector->change_color(lit, new_color);
     vertex_to_color[lit] = new_color;
     colorcount.push_back(1);
 }
@@ -198,6 +300,35 @@ void Graph::setUniqueColor(const vector<BLit>& lits)
     }
 }
 
+void Graph::getApproxOrbits(vector<vector<BLit> >& out)
+{
+    out.clear();
+    vector<uint32_t> cell_of;
+    if (!detector->equitable_cells(cell_of)) {
+        // no refinement, so all literals may be in one orbit
+        out.push_back(vector<BLit>());
+        for (uint32_t i = 0; i < 2*conf->nVars; i++) {
+            out.back().push_back(BLit::toBLit(i));
+        }
+        return;
+    }
+
+    std::map<uint32_t, uint32_t> cell_to_orbit;
+    vector<vector<BLit> > cells;
+    for (uint32_t i = 0; i < 2*conf->nVars; i++) {
+        auto it = cell_to_orbit.insert(std::make_pair(cell_of[i], cells.size())).first;
+        if (it->second == cells.size()) {
+            cells.push_back(vector<BLit>());
+        }
+        cells[it->second].push_back(BLit::toBLit(i));
+    }
+    for (auto& c: cells) {
+        if (c.size() > 1) {
+            out.push_back(std::move(c));
+        }
+    }
+}
+
 void Graph::getSymmetryGenerators(
     vector<shared_ptr<Permutation> >& out_perms
     , int64_t steps_lim
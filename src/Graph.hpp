@@ -34,14 +34,12 @@ THE SOFTWARE.
 class Matrix;
 class Group;
 
-namespace bliss {
-class Graph;
-}
+class SymmetryDetector;
 
 class Graph : public std::enable_shared_from_this<Graph>
 {
 public:
-    bliss::Graph* bliss_g = NULL;
+    SymmetryDetector* detector = NULL;
 
     ///keeps track of the number of times a color is used
     ///so that no color is never used (seems to give Saucy trouble)
@@ -51,12 +49,16 @@ public:
 
     //Dynamic graph
     Graph(Config* conf); ///<for online CNF
-    void add_clause(BID::BLit* start, uint32_t size);
+    void add_clause(const BID::BLit* start, uint32_t size);
+    ///clause i is lits[offsets[i]] to lits[offsets[i+1]-1]
+    void add_clauses(const BID::BLit* lits, const uint32_t* offsets, size_t num);
     void end_dynamic_cnf();
 
     uint32_t getNbNodes() const;
     void setUniqueColor(uint32_t lit);
     void setUniqueColor(const vector<BLit>& lits);
+    ///Cells of at least two literals of the equitable partition
+    void getApproxOrbits(vector<vector<BLit> >& out);
     void getSymmetryGenerators(
         vector<shared_ptr<Permutation> >& out_perms
         , int64_t steps_lim
@@ -79,6 +81,7 @@ private:
         , int64_t steps_lim
         , int64_t* out_steps_lim
     );
+    void chooseSplitHeuristic();
 
     vector<uint32_t> vertex_to_color;
 
@@ -87,7 +90,13 @@ private:
     uint32_t nbedges = 0;
 
     //dynamic CNF generation
-    vector<char> used_lits;
+    ///number of clauses each literal occurs in
+    vector<uint32_t> lit_occs;
+    uint32_t nbclauses = 0;
+    ///occurrences of each literal in the clauses of add_clauses(), zero
+    ///between calls, and the literals occurring
+    vector<uint32_t> batch_degrees;
+    vector<uint32_t> batch_lits;
 };
 
 #endif
@@ -0,0 +1,100 @@
+/******************************************
+Copyright (c) 2024 Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef BREAKID_SYMMETRY_DETECTOR_H
+#define BREAKID_SYMMETRY_DETECTOR_H
+
+#include <cstdint>
+#include <vector>
+
+struct Config;
+
+///Receives the generators found by a SymmetryDetector
+class GeneratorSink
+{
+public:
+    virtual ~GeneratorSink() {}
+    ///aut[v] is the image of vertex v, for all v < n
+    virtual void add_generator(uint32_t n, const uint32_t* aut) = 0;
+};
+
+///An engine detecting the automorphisms of an undirected, vertex-colored
+///graph. The graph is described to the engine incrementally, and may be
+///recolored between two searches.
+class SymmetryDetector
+{
+public:
+    virtual ~SymmetryDetector() {}
+    virtual const char* name() const = 0;
+
+    //Colored graph description
+    virtual uint32_t add_vertex(uint32_t color) = 0;
+    virtual void add_edge(uint32_t v1, uint32_t v2) = 0;
+    virtual void change_color(uint32_t v, uint32_t color) = 0;
+    virtual uint32_t nb_vertices() const = 0;
+
+    ///Hint that nb_new_vertices vertices are about to be added
+    virtual void reserve_vertices(uint32_t /*nb_new_vertices*/) {}
+    ///Hint that degree edges are about to be added at vertex v
+    virtual void reserve_edges(uint32_t /*v*/, uint32_t /*degree*/) {}
+
+    ///Reports generators of the automorphism group to the sink, spending at
+    ///most steps_lim steps; the steps left are written to out_steps_lim
+    ///if it is not NULL.
+    ///@return false if the search was stopped before its end
+    virtual bool find_generators(
+        GeneratorSink& sink
+        , int64_t steps_lim
+        , int64_t* out_steps_lim
+    ) = 0;
+
+    ///Order of the automorphism group found by the last find_generators(),
+    ///approximate. Returns false if the engine does not count it.
+    virtual bool group_size(long double& /*size*/) const
+    {
+        return false;
+    }
+
+    ///Statistics of the initial equitable partition, used to pick search
+    ///parameters. Returns false if the engine does not compute them.
+    virtual bool initial_partition_stats(
+        uint32_t& /*nb_cells*/
+        , uint32_t& /*nb_singletons*/
+        , uint32_t& /*max_cell_size*/
+    ) {
+        return false;
+    }
+
+    ///Sets cell_of[v] to an identifier of the cell of vertex v in the
+    ///coarsest equitable partition refining the colors, without any search.
+    ///Every orbit is inside a cell. Returns false if the engine does not
+    ///compute it.
+    virtual bool equitable_cells(std::vector<uint32_t>& /*cell_of*/)
+    {
+        return false;
+    }
+};
+
+///Engine chosen by conf->detector, on nb_vertices vertices of color 0
+SymmetryDetector* new_detector(Config* conf, uint32_t nb_vertices);
+
+#endif
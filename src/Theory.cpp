@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "Algebraic.hpp"
 #include "Breaking.hpp"
 #include "Graph.hpp"
+#include "SymmetryDetector.hpp"
 #include "breakid.hpp"
 
 using std::cout;
@@ -60,7 +61,7 @@ OnlCNF::~OnlCNF()
     graph = NULL;
 }
 
-void OnlCNF::add_clause(BID::BLit* lits, uint32_t size)
+void OnlCNF::add_clause(const BID::BLit* lits, uint32_t size)
 {
     graph->add_clause(lits, size);
     cl_sizes.push_back(size);
@@ -69,6 +70,15 @@ void OnlCNF::add_clause(BID::BLit* lits, uint32_t size)
     }
 }
 
+void OnlCNF::add_clauses(const BID::BLit* lits, const uint32_t* offsets, size_t num)
+{
+    graph->add_clauses(lits, offsets, num);
+    for (size_t i = 0; i < num; i++) {
+        cl_sizes.push_back(offsets[i + 1] - offsets[i]);
+    }
+    cl_lits.insert(cl_lits.end(), lits + offsets[0], lits + offsets[num]);
+}
+
 void OnlCNF::end_dynamic_cnf()
 {
     graph->end_dynamic_cnf();
@@ -79,6 +89,9 @@ void OnlCNF::set_new_group() {
     group = new Group(conf);
     vector<shared_ptr<Permutation> > symgens;
     graph->getSymmetryGenerators(symgens, conf->steps_lim, &conf->remain_steps_lim);
+    if (!graph->detector->group_size(groupSize)) {
+        groupSize = 0;
+    }
     for (auto symgen : symgens) {
         group->add(symgen);
     }
@@ -106,7 +119,7 @@ void OnlCNF::print(std::ostream&) const
 
 uint32_t OnlCNF::getSize() const
 {
-    return num_cls;
+    return cl_sizes.size();
 }
 
 ///Find set of clauses that subgroup permutates
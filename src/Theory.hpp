@@ -42,12 +42,15 @@ public:
     ~OnlCNF();
 
     void end_dynamic_cnf();
-    void add_clause(BID::BLit* lits, uint32_t size);
+    void add_clause(const BID::BLit* lits, uint32_t size);
+    void add_clauses(const BID::BLit* lits, const uint32_t* offsets, size_t num);
     void set_new_group();
     void set_old_group(Group* grp);
     const Graph* getGraph() const;
     Group* group = NULL;
     Graph* graph = NULL;
+    ///order of the group found by set_new_group(), approximate, 0 if unknown
+    long double groupSize = 0;
 
     void print(std::ostream& out) const;
     uint32_t getSize() const;
@@ -57,7 +60,6 @@ public:
 
 private:
     Config* conf;
-    uint32_t num_cls;
     vector<uint32_t> cl_sizes;
     vector<BLit> cl_lits;
 
@@ -71,6 +71,14 @@ class BigNum
         mpz_set_si(v, n);
     }
 
+    /**
+   * Set the number to \a n.
+   */
+    void assign(const BigNum& n)
+    {
+        mpz_set(v, n.v);
+    }
+
     /**
    * Multiply the number with \a n.
    */
@@ -110,6 +118,14 @@ class BigNum
         v = (long double)n;
     }
 
+    /**
+   * Set the number to \a n.
+   */
+    void assign(const BigNum& n)
+    {
+        v = n.v;
+    }
+
     /**
    * Multiply the number with \a n.
    */
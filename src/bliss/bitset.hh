@@ -0,0 +1,148 @@
+#ifndef BLISS_BITSET_HH
+#define BLISS_BITSET_HH
+
+/*
+  Copyright (c) 2024 Mate Soos
+  Released under the GNU Lesser General Public License version 3.
+
+  This file is part of bliss.
+
+  bliss is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, version 3 of the License.
+
+  bliss is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with bliss.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <vector>
+
+namespace bliss {
+
+/** \internal
+ * \brief A fixed size set of bits stored in 64-bit words, with
+ * operations on whole words.
+ *
+ * The bits past the size in the last word are always zero.
+ */
+class BitSet
+{
+   public:
+    typedef uint64_t Word;
+    static const unsigned int word_bits = 64;
+
+    /**
+   * Create a set of \a n zero bits.
+   */
+    BitSet(const unsigned int n = 0)
+        : n(n), words((n + word_bits - 1) / word_bits, 0)
+    {
+    }
+
+    unsigned int size() const
+    {
+        return n;
+    }
+
+    unsigned int nof_words() const
+    {
+        return words.size();
+    }
+
+    bool test(const unsigned int i) const
+    {
+        return (words[i / word_bits] >> (i % word_bits)) & 1;
+    }
+
+    void set(const unsigned int i)
+    {
+        words[i / word_bits] |= (Word)1 << (i % word_bits);
+    }
+
+    void reset(const unsigned int i)
+    {
+        words[i / word_bits] &= ~((Word)1 << (i % word_bits));
+    }
+
+    /** Set all the bits to zero. */
+    void clear()
+    {
+        for (Word& w : words)
+            w = 0;
+    }
+
+    /** Set all the bits to one. */
+    void fill()
+    {
+        for (Word& w : words)
+            w = ~(Word)0;
+        trim();
+    }
+
+    /** The \a i:th word, holding the bits 64i..64i+63. */
+    Word word(const unsigned int i) const
+    {
+        return words[i];
+    }
+
+    /** Set the \a i:th word; bits past the size must be zero. */
+    void set_word(const unsigned int i, const Word w)
+    {
+        words[i] = w;
+    }
+
+    /** this = this & other */
+    void and_with(const BitSet& other)
+    {
+        for (unsigned int i = 0; i < words.size(); i++)
+            words[i] &= other.words[i];
+    }
+
+    /** this = this & ~other */
+    void andnot_with(const BitSet& other)
+    {
+        for (unsigned int i = 0; i < words.size(); i++)
+            words[i] &= ~other.words[i];
+    }
+
+    /** The number of bits set. */
+    unsigned int count() const
+    {
+        unsigned int c = 0;
+        for (const Word w : words)
+            c += popcount(w);
+        return c;
+    }
+
+    static unsigned int popcount(Word w)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(w);
+#else
+        w = w - ((w >> 1) & 0x5555555555555555ULL);
+        w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+        w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return (unsigned int)((w * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+   private:
+    unsigned int n;
+    std::vector<Word> words;
+
+    void trim()
+    {
+        if (n % word_bits != 0)
+            words.back() &= ((Word)1 << (n % word_bits)) - 1;
+    }
+};
+
+} // namespace bliss
+
+#endif
@@ -1,11 +1,18 @@
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <cstdio>
+#include <cstring>
+#include <deque>
 #include <limits>
 #include <list>
+#include <mutex>
+#include <random>
 #include <set>
 #include <iostream>
+#include <thread>
+#include <unordered_map>
 
 #include "defs.hh"
 #include "graph.hh"
@@ -53,6 +60,8 @@ AbstractGraph::AbstractGraph()
     best_path_labeling_inv = 0;
     first_path_automorphism = 0;
     best_path_automorphism = 0;
+    path_arrays_size = 0;
+    workspace = 0;
     in_search = false;
 
     /* Default value for using "long prune" */
@@ -67,9 +76,43 @@ AbstractGraph::AbstractGraph()
 
     report_hook = 0;
     report_user_param = 0;
+
+    progress_hook = 0;
+    progress_user_param = 0;
+    progress_period = 0;
+
+    search_complete = false;
 }
 
 AbstractGraph::~AbstractGraph()
+{
+    free_path_arrays();
+    free_workspace();
+    long_prune_deallocate();
+
+    report_hook = 0;
+    report_user_param = 0;
+}
+
+void AbstractGraph::allocate_path_arrays(const unsigned int N)
+{
+    if (N == path_arrays_size)
+        return;
+    free_path_arrays();
+    first_path_labeling = (unsigned int*)malloc(N * sizeof(unsigned int));
+    first_path_labeling_inv = (unsigned int*)malloc(N * sizeof(unsigned int));
+    first_path_automorphism = (unsigned int*)malloc(N * sizeof(unsigned int));
+    best_path_labeling = (unsigned int*)malloc(N * sizeof(unsigned int));
+    best_path_labeling_inv = (unsigned int*)malloc(N * sizeof(unsigned int));
+    best_path_automorphism = (unsigned int*)malloc(N * sizeof(unsigned int));
+    if (!first_path_labeling || !first_path_labeling_inv ||
+        !first_path_automorphism || !best_path_labeling ||
+        !best_path_labeling_inv || !best_path_automorphism)
+        _OUT_OF_MEMORY();
+    path_arrays_size = N;
+}
+
+void AbstractGraph::free_path_arrays()
 {
     if (first_path_labeling) {
         free(first_path_labeling);
@@ -95,9 +138,7 @@ AbstractGraph::~AbstractGraph()
         free(best_path_automorphism);
         best_path_automorphism = 0;
     }
-
-    report_hook = 0;
-    report_user_param = 0;
+    path_arrays_size = 0;
 }
 
 /*-------------------------------------------------------------------------
@@ -125,7 +166,7 @@ void AbstractGraph::set_verbose_file(FILE* const fp)
 void AbstractGraph::refine_to_equitable()
 {
     /* Start refinement from all cells -> push 'em all in the splitting queue */
-    for (Partition::Cell* cell = p.first_cell; cell; cell = cell->next)
+    for (Partition::Cell* cell = p.first_cell; cell; cell = p.next_cell(cell))
         p.splitting_queue_add(cell);
 
     do_refine_to_equitable();
@@ -277,6 +318,14 @@ bool AbstractGraph::is_automorphism(const std::vector<unsigned int>& perm) const
  *
  *-------------------------------------------------------------------------*/
 
+/*
+ * The comparison to the first and best paths is done here, triple by
+ * triple, rather than over hashes of certificate prefixes: it stops at
+ * the first differing triple, where the refiner aborts, and a hash match
+ * could not tell that the certificates are equal anyway. Whole
+ * subcertificates are first compared by their length and eqref_hash at
+ * the end of the refinement of each level, see search().
+ */
 void AbstractGraph::cert_add(const unsigned int v1, const unsigned int v2,
                              const unsigned int v3)
 {
@@ -350,8 +399,13 @@ void AbstractGraph::cert_add_redundant(const unsigned int v1,
 void AbstractGraph::long_prune_init()
 {
     const unsigned int N = get_nof_vertices();
-    long_prune_temp.clear();
-    long_prune_temp.resize(N);
+    long_prune_begin = 0;
+    long_prune_end = 0;
+    /* The sets of the previous search are reused if the size is the same */
+    if (long_prune_temp.size() == N && !long_prune_fixed.empty())
+        return;
+    long_prune_temp = BitSet(N);
+    long_prune_mcrs_all = BitSet(N);
     /* Of how many automorphisms we can store information in
      the predefined, fixed amount of memory? */
     const unsigned int nof_fitting_in_max_mem =
@@ -365,8 +419,6 @@ void AbstractGraph::long_prune_init()
     long_prune_deallocate();
     long_prune_fixed.resize(N, 0);
     long_prune_mcrs.resize(N, 0);
-    long_prune_begin = 0;
-    long_prune_end = 0;
 }
 
 void AbstractGraph::long_prune_deallocate()
@@ -385,7 +437,7 @@ void AbstractGraph::long_prune_swap(const unsigned int i, const unsigned int j)
 {
     const unsigned int real_i = i % long_prune_max_stored_autss;
     const unsigned int real_j = j % long_prune_max_stored_autss;
-    std::vector<bool>* tmp = long_prune_fixed[real_i];
+    BitSet* tmp = long_prune_fixed[real_i];
     long_prune_fixed[real_i] = long_prune_fixed[real_j];
     long_prune_fixed[real_j] = tmp;
     tmp = long_prune_mcrs[real_i];
@@ -393,30 +445,30 @@ void AbstractGraph::long_prune_swap(const unsigned int i, const unsigned int j)
     long_prune_mcrs[real_j] = tmp;
 }
 
-std::vector<bool>& AbstractGraph::long_prune_allocget_fixed(
+BitSet& AbstractGraph::long_prune_allocget_fixed(
     const unsigned int index)
 {
     const unsigned int i = index % long_prune_max_stored_autss;
     if (!long_prune_fixed[i])
-        long_prune_fixed[i] = new std::vector<bool>(get_nof_vertices());
+        long_prune_fixed[i] = new BitSet(get_nof_vertices());
     return *long_prune_fixed[i];
 }
 
-std::vector<bool>& AbstractGraph::long_prune_get_fixed(const unsigned int index)
+BitSet& AbstractGraph::long_prune_get_fixed(const unsigned int index)
 {
     return *long_prune_fixed[index % long_prune_max_stored_autss];
 }
 
-std::vector<bool>& AbstractGraph::long_prune_allocget_mcrs(
+BitSet& AbstractGraph::long_prune_allocget_mcrs(
     const unsigned int index)
 {
     const unsigned int i = index % long_prune_max_stored_autss;
     if (!long_prune_mcrs[i])
-        long_prune_mcrs[i] = new std::vector<bool>(get_nof_vertices());
+        long_prune_mcrs[i] = new BitSet(get_nof_vertices());
     return *long_prune_mcrs[i];
 }
 
-std::vector<bool>& AbstractGraph::long_prune_get_mcrs(const unsigned int index)
+BitSet& AbstractGraph::long_prune_get_mcrs(const unsigned int index)
 {
     return *long_prune_mcrs[index % long_prune_max_stored_autss];
 }
@@ -433,24 +485,63 @@ void AbstractGraph::long_prune_add_automorphism(const unsigned int* aut)
         long_prune_begin++;
     }
     long_prune_end++;
-    std::vector<bool>& fixed = long_prune_allocget_fixed(long_prune_end - 1);
-    std::vector<bool>& mcrs = long_prune_allocget_mcrs(long_prune_end - 1);
+    BitSet& fixed = long_prune_allocget_fixed(long_prune_end - 1);
+    BitSet& mcrs = long_prune_allocget_mcrs(long_prune_end - 1);
     /* Mark nodes that are (i) fixed or (ii) minimal orbit representatives
-   * under the automorphism 'aut' */
-    for (unsigned int i = 0; i < N; i++) {
-        fixed[i] = (aut[i] == i);
-        if (long_prune_temp[i] == false) {
-            mcrs[i] = true;
-            unsigned int j = aut[i];
-            while (j != i) {
-                long_prune_temp[j] = true;
-                j = aut[j];
+   * under the automorphism 'aut', a word at a time */
+    for (unsigned int w = 0; w < fixed.nof_words(); w++) {
+        const unsigned int first = w * BitSet::word_bits;
+        const unsigned int last =
+            (N - first < BitSet::word_bits) ? N : first + BitSet::word_bits;
+        BitSet::Word fixed_word = 0;
+        BitSet::Word mcrs_word = 0;
+        for (unsigned int i = first; i < last; i++) {
+            const BitSet::Word bit = (BitSet::Word)1 << (i - first);
+            if (aut[i] == i)
+                fixed_word |= bit;
+            if (!long_prune_temp.test(i)) {
+                mcrs_word |= bit;
+                unsigned int j = aut[i];
+                while (j != i) {
+                    long_prune_temp.set(j);
+                    j = aut[j];
+                }
+            }
+        }
+        fixed.set_word(w, fixed_word);
+        mcrs.set_word(w, mcrs_word);
+        /* Clear the temp array on-the-fly, the elements up to last
+       are done... */
+        long_prune_temp.set_word(w, 0);
+    }
+}
+
+void AbstractGraph::long_prune_get_redundant(const Partition::Cell* const cell,
+                                             const unsigned int begin,
+                                             std::set<unsigned int>& redundant)
+{
+    const unsigned int* ep = p.elements + cell->first;
+    if (cell->length < long_prune_mcrs_all.nof_words()) {
+        /* Small cell: test its elements one by one */
+        for (unsigned int j = cell->length; j > 0; j--, ep++) {
+            for (unsigned int i = begin; i < long_prune_end; i++) {
+                if (!long_prune_get_mcrs(i).test(*ep)) {
+                    redundant.insert(*ep);
+                    break;
+                }
             }
-        } else {
-            mcrs[i] = false;
         }
-        /* Clear the temp array on-the-fly... */
-        long_prune_temp[i] = false;
+        return;
+    }
+    /* Large cell: intersect the mcrs sets word by word first */
+    long_prune_mcrs_all.fill();
+    for (unsigned int i = begin; i < long_prune_end; i++)
+        long_prune_mcrs_all.and_with(long_prune_get_mcrs(i));
+    if (long_prune_mcrs_all.count() == long_prune_mcrs_all.size())
+        return;
+    for (unsigned int j = cell->length; j > 0; j--, ep++) {
+        if (!long_prune_mcrs_all.test(*ep))
+            redundant.insert(*ep);
     }
 }
 
@@ -523,6 +614,23 @@ typedef struct {
     UintSeqHash eqref_hash;
 } PathInfo;
 
+typedef std::set<unsigned int, std::less<unsigned int> > FailureRecordingSet;
+
+class SearchWorkspace
+{
+   public:
+    std::vector<TreeNode> search_stack;
+    std::vector<PathInfo> first_path_info;
+    std::vector<PathInfo> best_path_info;
+    std::vector<FailureRecordingSet> failure_recording_hashes;
+};
+
+void AbstractGraph::free_workspace()
+{
+    delete workspace;
+    workspace = 0;
+}
+
 void AbstractGraph::search(const bool canonical, Stats& stats)
 {
     const unsigned int N = get_nof_vertices();
@@ -530,6 +638,7 @@ void AbstractGraph::search(const bool canonical, Stats& stats)
     unsigned int all_same_level = UINT_MAX;
 
     p.graph = this;
+    search_complete = true;
 
     /*
    * Must be done!
@@ -544,34 +653,6 @@ void AbstractGraph::search(const bool canonical, Stats& stats)
     stats.nof_leaf_nodes = 1;
     max_num_steps = &stats.max_num_steps;
 
-    /* Free old first path data structures */
-    if (first_path_labeling) {
-        free(first_path_labeling);
-        first_path_labeling = 0;
-    }
-    if (first_path_labeling_inv) {
-        free(first_path_labeling_inv);
-        first_path_labeling_inv = 0;
-    }
-    if (first_path_automorphism) {
-        free(first_path_automorphism);
-        first_path_automorphism = 0;
-    }
-
-    /* Free old best path data structures */
-    if (best_path_labeling) {
-        free(best_path_labeling);
-        best_path_labeling = 0;
-    }
-    if (best_path_labeling_inv) {
-        free(best_path_labeling_inv);
-        best_path_labeling_inv = 0;
-    }
-    if (best_path_automorphism) {
-        free(best_path_automorphism);
-        best_path_automorphism = 0;
-    }
-
     if (N == 0) {
         /* Nothing to do, return... */
         return;
@@ -603,18 +684,12 @@ void AbstractGraph::search(const bool canonical, Stats& stats)
     }
 
     /*
-   * Allocate space for the "first path" and "best path" labelings
+   * Allocate space for the "first path" and "best path" labelings,
+   * their inverses and the automorphisms
    */
-    if (first_path_labeling)
-        free(first_path_labeling);
-    first_path_labeling = (unsigned int*)calloc(N, sizeof(unsigned int));
-    if (!first_path_labeling)
-        _OUT_OF_MEMORY();
-    if (best_path_labeling)
-        free(best_path_labeling);
-    best_path_labeling = (unsigned int*)calloc(N, sizeof(unsigned int));
-    if (!best_path_labeling)
-        _OUT_OF_MEMORY();
+    allocate_path_arrays(N);
+    memset(first_path_labeling, 0, N * sizeof(unsigned int));
+    memset(best_path_labeling, 0, N * sizeof(unsigned int));
 
     /*
    * Is the initial partition discrete?
@@ -632,33 +707,8 @@ void AbstractGraph::search(const bool canonical, Stats& stats)
         return;
     }
 
-    /*
-   * Allocate the inverses of the "first path" and "best path" labelings
-   */
-    if (first_path_labeling_inv)
-        free(first_path_labeling_inv);
-    first_path_labeling_inv = (unsigned int*)calloc(N, sizeof(unsigned int));
-    if (!first_path_labeling_inv)
-        _OUT_OF_MEMORY();
-    if (best_path_labeling_inv)
-        free(best_path_labeling_inv);
-    best_path_labeling_inv = (unsigned int*)calloc(N, sizeof(unsigned int));
-    if (!best_path_labeling_inv)
-        _OUT_OF_MEMORY();
-
-    /*
-   * Allocate space for the automorphisms
-   */
-    if (first_path_automorphism)
-        free(first_path_automorphism);
-    first_path_automorphism = (unsigned int*)malloc(N * sizeof(unsigned int));
-    if (!first_path_automorphism)
-        _OUT_OF_MEMORY();
-    if (best_path_automorphism)
-        free(best_path_automorphism);
-    best_path_automorphism = (unsigned int*)malloc(N * sizeof(unsigned int));
-    if (!best_path_automorphism)
-        _OUT_OF_MEMORY();
+    memset(first_path_labeling_inv, 0, N * sizeof(unsigned int));
+    memset(best_path_labeling_inv, 0, N * sizeof(unsigned int));
 
     /*
    * Initialize orbit information so that all vertices are in their own orbits
@@ -671,11 +721,15 @@ void AbstractGraph::search(const bool canonical, Stats& stats)
    */
     initialize_certificate();
 
-    std::vector<TreeNode> search_stack;
-    std::vector<PathInfo> first_path_info;
-    std::vector<PathInfo> best_path_info;
+    if (!workspace)
+        workspace = new SearchWorkspace;
+    std::vector<TreeNode>& search_stack = workspace->search_stack;
+    std::vector<PathInfo>& first_path_info = workspace->first_path_info;
+    std::vector<PathInfo>& best_path_info = workspace->best_path_info;
 
     search_stack.clear();
+    first_path_info.clear();
+    best_path_info.clear();
 
     /* Initialize "long prune" data structures */
     if (opt_use_long_prune)
@@ -684,9 +738,9 @@ void AbstractGraph::search(const bool canonical, Stats& stats)
     /*
    * Initialize failure recording data structures
    */
-    typedef std::set<unsigned int, std::less<unsigned int> >
-        FailureRecordingSet;
-    std::vector<FailureRecordingSet> failure_recording_hashes;
+    std::vector<FailureRecordingSet>& failure_recording_hashes =
+        workspace->failure_recording_hashes;
+    failure_recording_hashes.clear();
 
     /*
    * Initialize component recursion data structures
@@ -767,11 +821,24 @@ void AbstractGraph::search(const bool canonical, Stats& stats)
     /*
    * The actual backtracking search
    */
+    Timer progress_timer;
+    unsigned int progress_countdown = progress_period;
     while (!search_stack.empty()
         && *max_num_steps > 0
     ) {
         //std::cout << "In stack" << std::endl;
         (*max_num_steps)--;
+        if (progress_hook && --progress_countdown == 0) {
+            progress_countdown = progress_period;
+            if (!(*progress_hook)(progress_user_param, stats,
+                                  progress_timer.get_duration())) {
+                if (verbstr && verbose_level >= 1) {
+                    fprintf(verbstr, "Search stopped by the progress hook\n");
+                    fflush(verbstr);
+                }
+                break;
+            }
+        }
         if (verbstr && verbose_level >= 2 && (*max_num_steps & 0xfff) == 0xfff) {
             fprintf(verbstr, "Until next in search stack: %.2f seconds, stats.max_num_steps: %ld\n",
                     timer1.get_duration(), *max_num_steps);
@@ -853,13 +920,13 @@ void AbstractGraph::search(const bool canonical, Stats& stats)
                     ? current_node.long_prune_begin
                     : long_prune_begin;
             for (unsigned int i = begin; i < long_prune_end; i++) {
-                const std::vector<bool>& fixed = long_prune_get_fixed(i);
+                const BitSet& fixed = long_prune_get_fixed(i);
 #if defined(BLISS_CONSISTENCY_CHECKS)
                 for (unsigned int l = 0; l < search_stack.size() - 2; l++)
-                    assert(fixed[search_stack[l].split_element]);
+                    assert(fixed.test(search_stack[l].split_element));
 #endif
-                if (fixed[search_stack[search_stack.size() - 1 - 1]
-                              .split_element] == false) {
+                if (!fixed.test(search_stack[search_stack.size() - 1 - 1]
+                                    .split_element)) {
                     long_prune_swap(begin, i);
                     begin++;
                     current_node.long_prune_begin = begin;
@@ -876,28 +943,25 @@ void AbstractGraph::search(const bool canonical, Stats& stats)
                         ? current_node.long_prune_begin
                         : long_prune_begin;
                 for (unsigned int i = begin; i < long_prune_end; i++) {
-                    const std::vector<bool>& fixed = long_prune_get_fixed(i);
+                    const BitSet& fixed = long_prune_get_fixed(i);
 #if defined(BLISS_CONSISTENCY_CHECKS)
                     for (unsigned int l = 0; l < search_stack.size() - 2; l++)
-                        assert(fixed[search_stack[l].split_element]);
+                        assert(fixed.test(search_stack[l].split_element));
 #endif
                     assert(
-                        fixed[search_stack[current_level - 1].split_element] ==
-                        true);
-                    if (fixed[search_stack[current_level - 1].split_element] ==
-                        false) {
+                        fixed.test(search_stack[current_level - 1].split_element));
+                    if (!fixed.test(
+                            search_stack[current_level - 1].split_element)) {
                         long_prune_swap(begin, i);
                         begin++;
                         current_node.long_prune_begin = begin;
                         continue;
                     }
-                    const std::vector<bool>& mcrs = long_prune_get_mcrs(i);
-                    unsigned int* ep = p.elements + cell->first;
-                    for (unsigned int j = cell->length; j > 0; j--, ep++) {
-                        if (mcrs[*ep] == false)
-                            current_node.long_prune_redundant.insert(*ep);
-                    }
                 }
+                /* The automorphisms begin,...,long_prune_end-1 fix the path */
+                if (begin < long_prune_end)
+                    long_prune_get_redundant(cell, begin,
+                                             current_node.long_prune_redundant);
             }
         }
 
@@ -1653,10 +1717,9 @@ void AbstractGraph::search(const bool canonical, Stats& stats)
         continue;
 
     } /* while(!search_stack.empty()) */
+    search_complete = search_stack.empty();
 
-    /* Free "long prune" technique memory */
-    if (opt_use_long_prune)
-        long_prune_deallocate();
+    /* The "long prune" memory is kept for the next search */
 
     /* Release component recursion data in partition */
     if (opt_use_comprec)
@@ -1673,15 +1736,75 @@ void AbstractGraph::find_automorphisms(Stats& stats,
     report_user_param = user_param;
 
     search(false, stats);
+}
 
-    if (first_path_labeling) {
-        free(first_path_labeling);
-        first_path_labeling = 0;
+void AbstractGraph::initial_partition_stats(unsigned int& nof_cells,
+                                            unsigned int& nof_singletons,
+                                            unsigned int& max_cell_size)
+{
+    std::vector<unsigned int> cell_of;
+    initial_partition_cells(cell_of);
+
+    /* cell_of[v] is the first position of the cell, so the size of a cell
+     * is the number of vertices with the same value */
+    std::vector<unsigned int> size(cell_of.size(), 0);
+    for (const unsigned int c : cell_of)
+        size[c]++;
+    nof_cells = 0;
+    nof_singletons = 0;
+    max_cell_size = 0;
+    for (const unsigned int s : size) {
+        if (s == 0)
+            continue;
+        nof_cells++;
+        if (s == 1)
+            nof_singletons++;
+        if (s > max_cell_size)
+            max_cell_size = s;
     }
-    if (best_path_labeling) {
-        free(best_path_labeling);
-        best_path_labeling = 0;
+}
+
+void AbstractGraph::initial_partition_cells(std::vector<unsigned int>& cell_of)
+{
+    const unsigned int N = get_nof_vertices();
+    cell_of.assign(N, 0);
+    if (N == 0)
+        return;
+
+    /* The same set-up as in search() */
+    p.graph = this;
+    remove_duplicate_edges();
+    Stats stats;
+    max_num_steps = &stats.max_num_steps;
+    p.init(N);
+    if (opt_use_comprec)
+        p.cr_init();
+    neighbour_heap.init(N);
+    in_search = false;
+    refine_compare_certificate = false;
+    compute_eqref_hash = false;
+
+    make_initial_equitable_partition();
+
+    for (Partition::Cell* cell = p.first_cell; cell; cell = p.next_cell(cell)) {
+        const unsigned int* ep = p.elements + cell->first;
+        for (unsigned int i = cell->length; i > 0; i--, ep++)
+            cell_of[*ep] = cell->first;
     }
+
+    if (opt_use_comprec)
+        p.cr_free();
+    max_num_steps = 0;
+}
+
+void AbstractGraph::set_progress_hook(
+    bool (*hook)(void* user_param, const Stats& stats, double elapsed),
+    void* user_param, const unsigned int period)
+{
+    assert(!hook || period > 0);
+    progress_hook = hook;
+    progress_user_param = user_param;
+    progress_period = period;
 }
 
 const unsigned int* AbstractGraph::canonical_form(
@@ -2321,7 +2444,7 @@ bool Digraph::split_neighbourhood_of_cell(Partition::Cell* const cell)
             }
             if (c == last_new_cell)
                 break;
-            c = c->next;
+            c = p.next_cell(c);
         }
     }
 
@@ -2383,7 +2506,7 @@ bool Digraph::split_neighbourhood_of_cell(Partition::Cell* const cell)
             }
             if (c == last_new_cell)
                 break;
-            c = c->next;
+            c = p.next_cell(c);
         }
     }
 
@@ -2716,7 +2839,7 @@ bool Digraph::is_equitable() const
     /*
    * Check equitabledness w.r.t. outgoing edges
    */
-    for (Partition::Cell* cell = p.first_cell; cell; cell = cell->next) {
+    for (Partition::Cell* cell = p.first_cell; cell; cell = p.next_cell(cell)) {
         if (cell->is_unit())
             continue;
 
@@ -2739,7 +2862,7 @@ bool Digraph::is_equitable() const
                 other_count[p.get_cell(*ei)->first]++;
             }
             for (Partition::Cell* cell2 = p.first_cell; cell2;
-                 cell2 = cell2->next) {
+                 cell2 = p.next_cell(cell2)) {
                 if (first_count[cell2->first] != other_count[cell2->first]) {
                     /* Not equitable */
                     return false;
@@ -2755,7 +2878,7 @@ bool Digraph::is_equitable() const
     /*
    * Check equitabledness w.r.t. incoming edges
    */
-    for (Partition::Cell* cell = p.first_cell; cell; cell = cell->next) {
+    for (Partition::Cell* cell = p.first_cell; cell; cell = p.next_cell(cell)) {
         if (cell->is_unit())
             continue;
 
@@ -2778,7 +2901,7 @@ bool Digraph::is_equitable() const
                 other_count[p.get_cell(*ei)->first]++;
             }
             for (Partition::Cell* cell2 = p.first_cell; cell2;
-                 cell2 = cell2->next) {
+                 cell2 = p.next_cell(cell2)) {
                 if (first_count[cell2->first] != other_count[cell2->first]) {
                     /* Not equitable */
                     return false;
@@ -3590,6 +3713,26 @@ void Graph::add_edge(const unsigned int vertex1, const unsigned int vertex2)
     vertices[vertex2].add_edge(vertex1);
 }
 
+/* Grows the capacity geometrically, so that repeated small reservations
+ * do not reallocate every time */
+template <class T>
+static void reserve_more(std::vector<T>& vec, const size_t nof_new)
+{
+    const size_t needed = vec.size() + nof_new;
+    if (needed > vec.capacity())
+        vec.reserve(std::max(needed, 2 * vec.capacity()));
+}
+
+void Graph::reserve_vertices(const unsigned int nof_new_vertices)
+{
+    reserve_more(vertices, nof_new_vertices);
+}
+
+void Graph::reserve_edges(const unsigned int v, const unsigned int nof_new_edges)
+{
+    reserve_more(vertices[v].edges, nof_new_edges);
+}
+
 void Graph::change_color(const unsigned int vertex, const unsigned int color)
 {
     vertices[vertex].color = color;
@@ -3879,6 +4022,644 @@ Graph* Graph::permute(const unsigned int* perm) const
     return g;
 }
 
+/*-------------------------------------------------------------------------
+ *
+ * Parallel automorphism search
+ *
+ *-------------------------------------------------------------------------*/
+
+namespace {
+
+/* State shared by the threads of Graph::find_automorphisms_parallel() */
+struct ParallelSearch {
+    const Graph* graph;
+    unsigned int N;
+    std::vector<unsigned int> color;
+    unsigned int new_color;
+    unsigned int root;
+    std::vector<unsigned int> root_labeling;
+
+    /* The elements of the root cell, and for each one the candidate
+     * automorphism mapping the root to it, computed by the threads */
+    std::vector<unsigned int> cell;
+    std::vector<std::vector<unsigned int> > candidate;
+    std::vector<char> computed;
+    std::vector<char> task_complete;
+
+    /* Orbits of the automorphisms reported, only used by one thread at a time */
+    Orbit orbits;
+
+    /* Orbits of all automorphisms found so far, under hint_mutex; elements
+     * in the orbit of the root are not searched speculatively */
+    Orbit hints;
+    std::mutex hint_mutex;
+
+    /* Serializes the user's hooks and the statistics */
+    std::mutex hook_mutex;
+    void (*report_hook)(void*, unsigned int, const unsigned int*);
+    void* report_user_param;
+    bool (*progress_hook)(void*, const Stats&, double);
+    void* progress_user_param;
+    unsigned int progress_period;
+    unsigned long int nof_reported;
+
+    std::atomic<bool> stop;
+    /* The steps not handed out to a search yet, under step_mutex */
+    int64_t steps_remain;
+    std::mutex step_mutex;
+
+    /* One deque per thread, the owner pops the front, thieves the back */
+    std::vector<std::deque<unsigned int> > work;
+    std::vector<std::mutex> work_mutex;
+
+    ParallelSearch(unsigned int nof_threads) : work(nof_threads), work_mutex(nof_threads) {}
+
+    bool next_task(unsigned int me, unsigned int& i)
+    {
+        for (unsigned int k = 0; k < work.size(); k++) {
+            const unsigned int victim = (me + k) % work.size();
+            std::lock_guard<std::mutex> lock(work_mutex[victim]);
+            if (work[victim].empty())
+                continue;
+            if (victim == me) {
+                i = work[victim].front();
+                work[victim].pop_front();
+            } else {
+                i = work[victim].back();
+                work[victim].pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /* Each search gets its own share of the remaining steps, so that the
+     * searches running together cannot overshoot the limit */
+    int64_t take_steps(unsigned int nof_shares)
+    {
+        std::lock_guard<std::mutex> lock(step_mutex);
+        if (steps_remain <= 0)
+            return 0;
+        const int64_t slice = std::max<int64_t>(steps_remain / nof_shares, 1);
+        steps_remain -= slice;
+        return slice;
+    }
+
+    /* Unused steps are given back, overshot ones taken */
+    void return_steps(int64_t unused)
+    {
+        std::lock_guard<std::mutex> lock(step_mutex);
+        steps_remain += unused;
+    }
+
+    void merge_hints(const unsigned int* aut)
+    {
+        std::lock_guard<std::mutex> lock(hint_mutex);
+        for (unsigned int i = 0; i < N; i++)
+            if (aut[i] != i)
+                hints.merge_orbits(i, aut[i]);
+    }
+
+    bool hinted_in_root_orbit(unsigned int e)
+    {
+        std::lock_guard<std::mutex> lock(hint_mutex);
+        return hints.get_minimal_representative(e) ==
+            hints.get_minimal_representative(root);
+    }
+
+    void report(const unsigned int* aut)
+    {
+        merge_hints(aut);
+        for (unsigned int i = 0; i < N; i++)
+            if (aut[i] != i)
+                orbits.merge_orbits(i, aut[i]);
+        std::lock_guard<std::mutex> lock(hook_mutex);
+        nof_reported++;
+        if (report_hook)
+            (*report_hook)(report_user_param, N, aut);
+    }
+};
+
+/* Automorphisms of the graph with the root individualized generate its stabilizer */
+void parallel_report_stabilizer(void* param, unsigned int, const unsigned int* aut)
+{
+    ((ParallelSearch*)param)->report(aut);
+}
+
+/* Automorphisms of the graph with another element individualized are only
+ * used for pruning, they are generated by the stabilizer and the
+ * automorphisms mapping the root to the elements of its orbit */
+void parallel_merge_hints(void* param, unsigned int, const unsigned int* aut)
+{
+    ((ParallelSearch*)param)->merge_hints(aut);
+}
+
+bool parallel_progress(void* param, const Stats& stats, double elapsed)
+{
+    ParallelSearch* ps = (ParallelSearch*)param;
+    if (ps->stop)
+        return false;
+    if (ps->progress_hook) {
+        std::lock_guard<std::mutex> lock(ps->hook_mutex);
+        if (!(*ps->progress_hook)(ps->progress_user_param, stats, elapsed))
+            ps->stop = true;
+    }
+    return !ps->stop;
+}
+
+/* Canonical labeling of the graph with element e individualized, within
+ * one of \a nof_shares shares of the remaining steps */
+bool parallel_canonical_labeling(ParallelSearch& ps, const Graph::SplittingHeuristic sh,
+                                 const unsigned int e, const unsigned int nof_shares,
+                                 void (*hook)(void*, unsigned int, const unsigned int*),
+                                 std::vector<unsigned int>& labeling, Stats& stats)
+{
+    if (ps.stop)
+        return false;
+    const int64_t budget = ps.take_steps(nof_shares);
+    if (budget <= 0)
+        return false;
+
+    std::vector<unsigned int> identity(ps.N);
+    for (unsigned int i = 0; i < ps.N; i++)
+        identity[i] = i;
+    Graph* const g = ps.graph->permute(identity);
+    g->set_splitting_heuristic(sh);
+    g->change_color(e, ps.new_color);
+    g->set_progress_hook(&parallel_progress, (void*)&ps,
+                         ps.progress_hook ? ps.progress_period : 64);
+
+    stats.max_num_steps = budget;
+    const unsigned int* lab = g->canonical_form(stats, hook, (void*)&ps);
+    labeling.assign(lab, lab + ps.N);
+    ps.return_steps(stats.max_num_steps);
+    const bool done = g->last_search_complete();
+    delete g;
+    return done;
+}
+
+/* Searches the i-th element of the root cell: if the canonical forms with
+ * it and with the root individualized are equal, the candidate maps the
+ * root to it */
+unsigned long int parallel_search_element(ParallelSearch& ps, const Graph::SplittingHeuristic sh,
+                                          const unsigned int i, const unsigned int nof_shares)
+{
+    const unsigned int e = ps.cell[i];
+    std::vector<unsigned int> labeling;
+    Stats stats;
+    ps.computed[i] = true;
+    ps.task_complete[i] = parallel_canonical_labeling(ps, sh, e, nof_shares,
+                                                      &parallel_merge_hints,
+                                                      labeling, stats);
+    if (!ps.task_complete[i])
+        return stats.get_nof_nodes();
+
+    std::vector<unsigned int> inv(ps.N);
+    std::vector<unsigned int>& aut = ps.candidate[i];
+    aut.resize(ps.N);
+    for (unsigned int k = 0; k < ps.N; k++)
+        inv[labeling[k]] = k;
+    for (unsigned int k = 0; k < ps.N; k++)
+        aut[k] = inv[ps.root_labeling[k]];
+    bool ok = aut[ps.root] == e;
+    for (unsigned int k = 0; ok && k < ps.N; k++)
+        ok = ps.color[k] == ps.color[aut[k]];
+    if (ok && ps.graph->is_automorphism(aut)) {
+        ps.merge_hints(aut.data());
+    } else {
+        aut.clear();
+    }
+    return stats.get_nof_nodes();
+}
+
+} // namespace
+
+void Graph::find_automorphisms_parallel(Stats& stats,
+                                        void (*hook)(void* user_param,
+                                                     unsigned int n,
+                                                     const unsigned int* aut),
+                                        void* hook_user_param,
+                                        unsigned int nof_threads)
+{
+    const unsigned int N = get_nof_vertices();
+    if (nof_threads < 2 || N == 0) {
+        find_automorphisms(stats, hook, hook_user_param);
+        return;
+    }
+
+    /* Find the cell to split at the root, as search() would */
+    const int64_t budget = stats.max_num_steps;
+    stats.reset();
+    search_complete = true;
+    p.graph = this;
+    remove_duplicate_edges();
+    max_num_steps = &stats.max_num_steps;
+    p.init(N);
+    neighbour_heap.init(N);
+    in_search = false;
+    refine_compare_certificate = false;
+    compute_eqref_hash = false;
+    if (opt_use_comprec)
+        p.cr_init();
+    stats.max_num_steps = budget;
+    make_initial_equitable_partition();
+    max_num_steps = 0;
+    if (p.is_discrete()) {
+        if (opt_use_comprec)
+            p.cr_free();
+        return;
+    }
+    cr_level = 0;
+    Partition::Cell* const cell = find_next_cell_to_be_splitted(p.first_cell);
+    ParallelSearch ps(nof_threads);
+    ps.cell.assign(p.elements + cell->first,
+                   p.elements + cell->first + cell->length);
+    if (opt_use_comprec)
+        p.cr_free();
+
+    ps.graph = this;
+    ps.N = N;
+    ps.new_color = 0;
+    ps.color.resize(N);
+    for (unsigned int i = 0; i < N; i++) {
+        ps.color[i] = vertices[i].color;
+        ps.new_color = std::max(ps.new_color, vertices[i].color + 1);
+    }
+    ps.root = ps.cell[0];
+    ps.candidate.resize(ps.cell.size());
+    ps.computed.assign(ps.cell.size(), false);
+    ps.task_complete.assign(ps.cell.size(), false);
+    ps.orbits.init(N);
+    ps.hints.init(N);
+    ps.report_hook = hook;
+    ps.report_user_param = hook_user_param;
+    ps.progress_hook = progress_hook;
+    ps.progress_user_param = progress_user_param;
+    ps.progress_period = progress_period;
+    ps.nof_reported = 0;
+    ps.stop = false;
+    ps.steps_remain = stats.max_num_steps;
+
+    /* The stabilizer of the root, this is the "first path". It is searched
+     * sequentially, only the other elements of the root cell are searched
+     * in parallel */
+    Stats root_stats;
+    bool complete = parallel_canonical_labeling(ps, sh, ps.root, 1,
+                                                &parallel_report_stabilizer,
+                                                ps.root_labeling, root_stats);
+
+    std::vector<unsigned long int> nodes(nof_threads, 0);
+    nodes[0] = root_stats.get_nof_nodes();
+    if (complete) {
+        for (unsigned int i = 1; i < ps.cell.size(); i++)
+            ps.work[i % nof_threads].push_back(i);
+
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < nof_threads; t++) {
+            threads.push_back(std::thread([&ps, &nodes, t, this]() {
+                unsigned int i;
+                while (!ps.stop && ps.next_task(t, i)) {
+                    if (!ps.hinted_in_root_orbit(ps.cell[i]))
+                        nodes[t] += parallel_search_element(ps, sh, i, ps.work.size());
+                }
+            }));
+        }
+        for (auto& t : threads)
+            t.join();
+    }
+
+    /* The automorphisms are reported in the order of the cell, and only
+     * if they extend the orbit of the root, as the sequential search
+     * would: the generators do not depend on the scheduling of the
+     * threads. Elements skipped by the threads but not in the orbit yet
+     * are searched now. */
+    for (unsigned int i = 1; complete && i < ps.cell.size(); i++) {
+        const unsigned int e = ps.cell[i];
+        if (ps.orbits.get_minimal_representative(e) ==
+            ps.orbits.get_minimal_representative(ps.root))
+            continue;
+        if (!ps.computed[i])
+            nodes[0] += parallel_search_element(ps, sh, i, 1);
+        if (!ps.task_complete[i])
+            complete = false;
+        else if (!ps.candidate[i].empty())
+            ps.report(ps.candidate[i].data());
+    }
+
+    /* |Aut| = |stabilizer of the root| * |orbit of the root| */
+    stats.group_size.assign(root_stats.group_size);
+    stats.group_size.multiply(ps.orbits.orbit_size(ps.root));
+    stats.group_size_approx =
+        root_stats.group_size_approx * ps.orbits.orbit_size(ps.root);
+    stats.nof_nodes = 0;
+    for (auto n : nodes)
+        stats.nof_nodes += n;
+    stats.nof_leaf_nodes = root_stats.nof_leaf_nodes;
+    stats.max_level = root_stats.max_level + 1;
+    stats.nof_generators = ps.nof_reported;
+    stats.max_num_steps = ps.steps_remain;
+    search_complete = complete && !ps.stop;
+}
+
+namespace {
+
+/* Stabilizer chain for the random Schreier-Sims completion of
+ * Graph::find_automorphisms_randomized(). Level l holds the orbit of
+ * base[l] under the generators fixing base[0..l-1], as a Schreier tree:
+ * tree[l][x] is the generator mapping the parent of x to x. */
+struct SchreierSims {
+    unsigned int N;
+    std::vector<unsigned int> base;
+    std::vector<std::vector<unsigned int> > gens;
+    std::vector<std::vector<unsigned int> > gens_inv;
+    std::vector<unsigned int> gen_level;
+    std::vector<std::unordered_map<unsigned int, unsigned int> > tree;
+    std::vector<std::vector<unsigned int> > orbit;
+
+    SchreierSims(unsigned int n, const std::vector<unsigned int>& b)
+        : N(n), base(b), tree(b.size()), orbit(b.size())
+    {
+        for (unsigned int l = 0; l < base.size(); l++) {
+            tree[l][base[l]] = UINT_MAX;
+            orbit[l].push_back(base[l]);
+        }
+    }
+
+    /* Replaces h by its residue, returns the level at which the residue
+     * leaves the chain, or base.size() if h is in the group */
+    unsigned int sift(std::vector<unsigned int>& h) const
+    {
+        for (unsigned int l = 0; l < base.size(); l++) {
+            unsigned int x = h[base[l]];
+            if (tree[l].find(x) == tree[l].end())
+                return l;
+            while (x != base[l]) {
+                const std::vector<unsigned int>& inv = gens_inv[tree[l].at(x)];
+                for (unsigned int i = 0; i < N; i++)
+                    h[i] = inv[h[i]];
+                x = inv[x];
+            }
+        }
+        return base.size();
+    }
+
+    /* Adds h, which fixes base[0..level-1], and extends the orbits */
+    void add(const std::vector<unsigned int>& h, const unsigned int level)
+    {
+        const unsigned int g = gens.size();
+        gens.push_back(h);
+        gens_inv.push_back(std::vector<unsigned int>(N));
+        for (unsigned int i = 0; i < N; i++)
+            gens_inv[g][h[i]] = i;
+        gen_level.push_back(level);
+
+        for (unsigned int l = 0; l <= level; l++) {
+            std::vector<unsigned int>& o = orbit[l];
+            const size_t old_size = o.size();
+            for (size_t i = 0; i < old_size; i++)
+                extend(l, o[i], g);
+            for (size_t i = old_size; i < o.size(); i++)
+                for (unsigned int j = 0; j < gens.size(); j++)
+                    if (gen_level[j] >= l)
+                        extend(l, o[i], j);
+        }
+    }
+
+    void extend(const unsigned int l, const unsigned int x, const unsigned int g)
+    {
+        const unsigned int y = gens[g][x];
+        if (tree[l].emplace(y, g).second)
+            orbit[l].push_back(y);
+    }
+};
+
+} // namespace
+
+void Graph::find_automorphisms_randomized(Stats& stats,
+                                          void (*hook)(void* user_param,
+                                                       unsigned int n,
+                                                       const unsigned int* aut),
+                                          void* hook_user_param,
+                                          unsigned int nof_fails,
+                                          unsigned long seed)
+{
+    const unsigned int N = get_nof_vertices();
+    const int64_t budget = stats.max_num_steps;
+    stats.reset();
+    stats.max_num_steps = budget;
+    search_complete = true;
+    if (N == 0)
+        return;
+
+    /* The same set-up as in search(), without component recursion */
+    const bool use_comprec = opt_use_comprec;
+    opt_use_comprec = false;
+    p.graph = this;
+    remove_duplicate_edges();
+    max_num_steps = &stats.max_num_steps;
+    p.init(N);
+    neighbour_heap.init(N);
+    in_search = false;
+    refine_compare_certificate = false;
+    compute_eqref_hash = false;
+    make_initial_equitable_partition();
+    compute_eqref_hash = true;
+
+    std::mt19937_64 rnd(seed);
+
+    /* Walks down to a leaf from the current partition, individualizing the
+     * smallest element of each target cell if leftmost, as search() does on
+     * its first path, and a random one otherwise.
+     * The trace hashes the refinements on the way: it is equal for leaves
+     * mapped to each other by an automorphism. */
+    auto walk = [&](UintSeqHash trace, const bool leftmost,
+                    std::vector<unsigned int>& labeling,
+                    std::vector<unsigned int>* path,
+                    std::vector<UintSeqHash>* path_traces,
+                    std::vector<Partition::BacktrackPoint>* path_bps) -> unsigned int {
+        unsigned int level = 0;
+        while (!p.is_discrete()) {
+            Partition::Cell* const cell = find_next_cell_to_be_splitted(p.first_cell);
+            unsigned int v = p.elements[cell->first + rnd() % cell->length];
+            if (leftmost)
+                v = *std::min_element(p.elements + cell->first,
+                                      p.elements + cell->first + cell->length);
+            if (path) {
+                path->push_back(v);
+                path_traces->push_back(trace);
+                path_bps->push_back(p.set_backtrack_point());
+            }
+            trace.update(cell->first);
+            trace.update(cell->length);
+            Partition::Cell* const new_cell = p.individualize(cell, v);
+            if (cell->is_unit())
+                refine_to_equitable(cell, new_cell);
+            else
+                refine_to_equitable(new_cell);
+            trace.update(eqref_hash.get_value());
+            stats.nof_nodes++;
+            level++;
+        }
+        stats.nof_leaf_nodes++;
+        if (level > stats.max_level)
+            stats.max_level = level;
+        update_labeling(labeling.data());
+        return trace.get_value();
+    };
+
+    /* The first path is the leftmost one, as in search(); its individualized
+     * elements are the base of the stabilizer chain */
+    const Partition::BacktrackPoint root = p.set_backtrack_point();
+    std::vector<unsigned int> labeling(N);
+    std::vector<unsigned int> base;
+    std::vector<UintSeqHash> base_traces;
+    std::vector<Partition::BacktrackPoint> base_bps;
+    const unsigned int first_trace =
+        walk(UintSeqHash(), true, labeling, &base, &base_traces, &base_bps);
+    SchreierSims chain(N, base);
+
+    /* One leaf per trace value, stored as the inverse of its labeling,
+     * in at most 2^24 entries */
+    const size_t max_stored = std::max((size_t)64, ((size_t)1 << 24) / N);
+    std::unordered_map<unsigned int, std::vector<unsigned int> > stored;
+    std::vector<unsigned int>& first_inv = stored[first_trace];
+    first_inv.resize(N);
+    for (unsigned int i = 0; i < N; i++)
+        first_inv[labeling[i]] = i;
+
+    /* Tries the leaf in 'labeling': returns 1 if it gave a new generator,
+     * 0 if an automorphism already in the group, -1 if no automorphism */
+    std::vector<unsigned int> aut(N);
+    std::vector<unsigned int> residue;
+    auto try_leaf = [&](const unsigned int trace) -> int {
+        auto it = stored.find(trace);
+        if (it == stored.end()) {
+            if (stored.size() < max_stored) {
+                std::vector<unsigned int>& inv = stored[trace];
+                inv.resize(N);
+                for (unsigned int i = 0; i < N; i++)
+                    inv[labeling[i]] = i;
+            }
+            return -1;
+        }
+        /* Maps the new leaf to the stored one */
+        for (unsigned int i = 0; i < N; i++)
+            aut[i] = it->second[labeling[i]];
+        bool ok = true;
+        for (unsigned int i = 0; ok && i < N; i++)
+            ok = vertices[i].color == vertices[aut[i]].color;
+        if (!ok || !is_automorphism(aut)) {
+            stats.nof_bad_nodes++;
+            return -1;
+        }
+        residue = aut;
+        const unsigned int level = chain.sift(residue);
+        if (level == base.size())
+            return 0;
+        chain.add(residue, level);
+        stats.nof_generators++;
+        if (hook)
+            (*hook)(hook_user_param, N, aut.data());
+        return 1;
+    };
+
+    /* The progress hook is called every progress_period checks, as in search() */
+    Timer progress_timer;
+    unsigned int progress_countdown = progress_period;
+    auto interrupted = [&]() -> bool {
+        bool stop = stats.max_num_steps <= 0;
+        if (!stop && progress_hook && --progress_countdown == 0) {
+            progress_countdown = progress_period;
+            stop = !(*progress_hook)(progress_user_param, stats, progress_timer.get_duration());
+        }
+        if (stop)
+            search_complete = false;
+        return stop;
+    };
+
+    /* Leftmost paths deviating from the first path at one level, from the
+     * deepest level up, as search() does without searching the subtrees.
+     * Their automorphisms fix the base prefix and have a small support,
+     * which suits symmetry breaking better than random group elements.
+     * As in search(), only the smallest element of each orbit of the
+     * automorphisms found so far is tried, and a level is left after
+     * nof_fails consecutive failures. */
+    Orbit fp_orbits;
+    fp_orbits.init(N);
+    bool stopped = false;
+    for (unsigned int l = base.size(); !stopped && l-- > 0;) {
+        p.goto_backtrack_point(base_bps[l]);
+        const Partition::Cell* const cell = p.get_cell(base[l]);
+        std::vector<unsigned int> cell_elements(p.elements + cell->first,
+                                                p.elements + cell->first + cell->length);
+        std::sort(cell_elements.begin(), cell_elements.end());
+        unsigned int fails = 0;
+        for (unsigned int i = 0; i < cell_elements.size() && fails < nof_fails; i++) {
+            const unsigned int v = cell_elements[i];
+            if (!fp_orbits.is_minimal_representative(v) ||
+                fp_orbits.get_minimal_representative(v) ==
+                    fp_orbits.get_minimal_representative(base[l]))
+                continue;
+            if ((stopped = interrupted()))
+                break;
+            const Partition::BacktrackPoint bp = p.set_backtrack_point();
+            Partition::Cell* const target = p.get_cell(v);
+            UintSeqHash trace = base_traces[l];
+            trace.update(target->first);
+            trace.update(target->length);
+            Partition::Cell* const new_cell = p.individualize(target, v);
+            if (target->is_unit())
+                refine_to_equitable(target, new_cell);
+            else
+                refine_to_equitable(new_cell);
+            trace.update(eqref_hash.get_value());
+            stats.nof_nodes++;
+            if (try_leaf(walk(trace, true, labeling, 0, 0, 0)) == 1) {
+                for (unsigned int j = 0; j < N; j++)
+                    if (aut[j] != j)
+                        fp_orbits.merge_orbits(j, aut[j]);
+                fails = 0;
+            } else {
+                fails++;
+            }
+            p.goto_backtrack_point(bp);
+        }
+    }
+    p.goto_backtrack_point(root);
+
+    /* Random walks from the root, their automorphisms are random elements
+     * of the group: once nof_fails consecutive ones are in the group found,
+     * it is the whole group with high probability. Leaves without a stored
+     * leaf of the same trace, or not related to it by an automorphism, say
+     * nothing about the group: they only count towards a larger limit, to
+     * stop on graphs where they never match. */
+    unsigned int fails = 0;
+    unsigned long int misses = 0;
+    const unsigned long int max_misses = 64UL * nof_fails;
+    while (!stopped && !base.empty() && fails < nof_fails && misses < max_misses) {
+        if ((stopped = interrupted()))
+            break;
+        const Partition::BacktrackPoint bp = p.set_backtrack_point();
+        const int r = try_leaf(walk(UintSeqHash(), false, labeling, 0, 0, 0));
+        p.goto_backtrack_point(bp);
+        if (r < 0) {
+            misses++;
+        } else {
+            fails = (r == 0) ? fails + 1 : 0;
+            misses = 0;
+        }
+    }
+
+    /* The order of the group generated so far, a lower bound */
+    for (unsigned int l = 0; l < base.size(); l++) {
+        stats.group_size.multiply(chain.orbit[l].size());
+        stats.group_size_approx *= chain.orbit[l].size();
+    }
+    max_num_steps = 0;
+    compute_eqref_hash = false;
+    opt_use_comprec = use_comprec;
+}
+
 /*-------------------------------------------------------------------------
  *
  * Print graph in graphviz format
@@ -4110,7 +4891,7 @@ bool Graph::split_neighbourhood_of_cell(Partition::Cell* const cell)
             }
             if (c == last_new_cell)
                 break;
-            c = c->next;
+            c = p.next_cell(c);
         }
     }
 
@@ -4317,7 +5098,7 @@ bool Graph::is_equitable() const
     std::vector<unsigned int> first_count = std::vector<unsigned int>(N, 0);
     std::vector<unsigned int> other_count = std::vector<unsigned int>(N, 0);
 
-    for (Partition::Cell* cell = p.first_cell; cell; cell = cell->next) {
+    for (Partition::Cell* cell = p.first_cell; cell; cell = p.next_cell(cell)) {
         if (cell->is_unit())
             continue;
 
@@ -4341,7 +5122,7 @@ bool Graph::is_equitable() const
                 other_count[p.get_cell(*ei)->first]++;
             }
             for (Partition::Cell* cell2 = p.first_cell; cell2;
-                 cell2 = cell2->next) {
+                 cell2 = p.next_cell(cell2)) {
                 if (first_count[cell2->first] != other_count[cell2->first]) {
                     /* Not equitable */
                     return false;
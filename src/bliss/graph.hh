@@ -32,7 +32,9 @@ class AbstractGraph;
 #include <cstdio>
 #include <vector>
 #include <limits>
+#include <set>
 #include "bignum.hh"
+#include "bitset.hh"
 #include "heap.hh"
 #include "kqueue.hh"
 #include "kstack.hh"
@@ -42,12 +44,15 @@ class AbstractGraph;
 
 namespace bliss {
 
+class SearchWorkspace;
+
 /**
  * \brief Statistics returned by the bliss search algorithm.
  */
 class Stats
 {
     friend class AbstractGraph;
+    friend class Graph;
     /** \internal The size of the automorphism group. */
     BigNum group_size;
     /** \internal An approximation (due to possible overflows) of
@@ -145,6 +150,8 @@ class Stats
 class AbstractGraph
 {
     friend class Partition;
+
+   protected:
     int64_t* max_num_steps;
 
    public:
@@ -251,6 +258,50 @@ class AbstractGraph
                                          const unsigned int* aut),
                             void* hook_user_param);
 
+    /**
+   * Set a hook that is called periodically during the search, once every
+   * \a period search tree nodes.
+   * The first argument \a user_param for the hook is the
+   * \a hook_user_param given below,
+   * the second argument \a stats holds the search statistics so far
+   * (including the remaining step budget in Stats::max_num_steps) and
+   * the third argument \a elapsed is the time (in seconds) spent in the
+   * search so far.
+   * If the hook returns false, the search is stopped early; the generators
+   * reported until then remain valid.
+   * Do not call any member functions in the hook.
+   * Passing a null \a hook disables the progress reporting.
+   */
+    void set_progress_hook(bool (*hook)(void* user_param, const Stats& stats,
+                                        double elapsed),
+                           void* hook_user_param,
+                           const unsigned int period);
+
+    /**
+   * Returns true if the last search explored the whole search tree, and
+   * false if it ran out of steps or was stopped by the progress hook.
+   */
+    bool last_search_complete() const { return search_complete; }
+
+    /**
+   * Compute the initial equitable partition, as the search does first,
+   * and return the number of its cells, the number of its singleton cells
+   * and the size of its largest cell.
+   * Much cheaper than a search; meant for choosing the search options.
+   */
+    void initial_partition_stats(unsigned int& nof_cells,
+                                 unsigned int& nof_singletons,
+                                 unsigned int& max_cell_size);
+
+    /**
+   * Compute the initial equitable partition, as the search does first,
+   * and set \a cell_of[v] to the index of the first position of the cell
+   * of vertex v. Every orbit of the automorphism group is included in a
+   * cell, so the cells approximate the orbits from above, without any
+   * search; a vertex in a singleton cell is fixed by all automorphisms.
+   */
+    void initial_partition_cells(std::vector<unsigned int>& cell_of);
+
     /**
    * Otherwise the same as find_automorphisms() except that
    * a canonical labeling of the graph (a bijection on
@@ -387,12 +438,14 @@ class AbstractGraph
    * Maximum amount of automorphisms stored for the long prune method;
    * less than this is stored if the memory limit above is reached first
    */
-    static const unsigned int long_prune_options_max_stored_auts = 100;
+    static const unsigned int long_prune_options_max_stored_auts = 1000;
 
     unsigned int long_prune_max_stored_autss;
-    std::vector<std::vector<bool>*> long_prune_fixed;
-    std::vector<std::vector<bool>*> long_prune_mcrs;
-    std::vector<bool> long_prune_temp;
+    std::vector<BitSet*> long_prune_fixed;
+    std::vector<BitSet*> long_prune_mcrs;
+    BitSet long_prune_temp;
+    /* The intersection of the mcrs sets of the stored automorphisms */
+    BitSet long_prune_mcrs_all;
     unsigned int long_prune_begin;
     unsigned int long_prune_end;
     /** \internal
@@ -404,10 +457,18 @@ class AbstractGraph
    */
     void long_prune_deallocate();
     void long_prune_add_automorphism(const unsigned int* aut);
-    std::vector<bool>& long_prune_get_fixed(const unsigned int index);
-    std::vector<bool>& long_prune_allocget_fixed(const unsigned int index);
-    std::vector<bool>& long_prune_get_mcrs(const unsigned int index);
-    std::vector<bool>& long_prune_allocget_mcrs(const unsigned int index);
+    BitSet& long_prune_get_fixed(const unsigned int index);
+    BitSet& long_prune_allocget_fixed(const unsigned int index);
+    BitSet& long_prune_get_mcrs(const unsigned int index);
+    BitSet& long_prune_allocget_mcrs(const unsigned int index);
+    /** \internal
+   * Insert in \a redundant the elements of \a cell that are not minimal
+   * orbit representatives under some of the stored automorphisms
+   * begin,...,long_prune_end-1
+   */
+    void long_prune_get_redundant(const Partition::Cell* const cell,
+                                  const unsigned int begin,
+                                  std::set<unsigned int>& redundant);
     /** \internal
    * Swap the i:th and j:th stored automorphism information;
    * i and j must be "in window, i.e. in [long_prune_begin,long_prune_end[
@@ -455,6 +516,18 @@ class AbstractGraph
     Orbit best_path_orbits;
     unsigned int* best_path_automorphism;
 
+    /* The number of vertices the path labelings and automorphisms above
+   * were allocated for; they are reused by the next search of a graph
+   * of the same size */
+    unsigned int path_arrays_size;
+    void allocate_path_arrays(const unsigned int N);
+    void free_path_arrays();
+
+    /* The search stacks, kept between searches so that their memory
+   * is reused */
+    SearchWorkspace* workspace;
+    void free_workspace();
+
     void update_labeling(unsigned int* const lab);
     void update_labeling_and_its_inverse(unsigned int* const lab,
                                          unsigned int* const lab_inv);
@@ -483,6 +556,13 @@ class AbstractGraph
                         const unsigned int* aut);
     void* report_user_param;
 
+    bool (*progress_hook)(void* user_param, const Stats& stats,
+                          double elapsed);
+    void* progress_user_param;
+    unsigned int progress_period;
+
+    bool search_complete;
+
     /*
    *
    * Nonuniform component recursion (NUCR)
@@ -744,6 +824,16 @@ class Graph : public AbstractGraph
    */
     void add_edge(const unsigned int v1, const unsigned int v2);
 
+    /**
+   * Reserve memory for \a nof_new_vertices more vertices.
+   */
+    void reserve_vertices(const unsigned int nof_new_vertices);
+
+    /**
+   * Reserve memory for \a nof_new_edges more edges at the vertex \a v.
+   */
+    void reserve_edges(const unsigned int v, const unsigned int nof_new_edges);
+
     /**
    * Change the color of the vertex \a vertex to \a color.
    */
@@ -769,6 +859,63 @@ class Graph : public AbstractGraph
     {
         sh = shs;
     }
+
+    /**
+   * Otherwise the same as find_automorphisms(), but runs on
+   * \a nof_threads threads.
+   * The first non-singleton cell T of the initial equitable partition is
+   * fixed: for its first element v, the canonical form of the graph with
+   * v individualized gives the generators of the stabilizer of v, reported
+   * first. This search is sequential, only the rest runs in parallel:
+   * for every other element e of T, the canonical form with e
+   * individualized is computed, and if it equals the one of v, it gives
+   * an automorphism mapping v to e. These elements are handed out to the
+   * threads through work-stealing deques; each search is given its own
+   * share of the remaining steps when it starts, so that the searches
+   * running together stay within the limit. The orbits of all
+   * automorphisms found so far are shared, and elements already in the
+   * orbit of v are skipped.
+   * The automorphisms mapping v to e are then reported in the order of T,
+   * only if e is not yet in the orbit of v under the ones reported, so
+   * unless the step limit is reached, the generators do not depend on the
+   * scheduling of the threads.
+   * The hook is never called concurrently; the progress hook, if set, is
+   * also serialized, and stops all threads if it returns false.
+   * Falls back to find_automorphisms() if \a nof_threads < 2.
+   */
+    void find_automorphisms_parallel(Stats& stats,
+                                     void (*hook)(void* user_param,
+                                                  unsigned int n,
+                                                  const unsigned int* aut),
+                                     void* hook_user_param,
+                                     unsigned int nof_threads);
+
+    /**
+   * A randomized alternative to find_automorphisms(), for graphs too large
+   * for the exhaustive search.
+   * The first path of the search tree is followed as in search(), and its
+   * individualized elements form the base of a stabilizer chain. Then,
+   * from the deepest level up, leftmost paths deviating from the first
+   * path at that level are compared to the first leaf, without searching
+   * their subtrees. Finally, random paths, individualizing a random element
+   * of the target cell at each level, are compared to stored leaves with
+   * the same refinement trace, and the automorphisms are sifted through
+   * the chain (random Schreier-Sims).
+   * The automorphisms not in the group generated so far are reported to
+   * the hook. Stops after \a nof_fails consecutive random automorphisms
+   * that were already in the group, or after 64 times as many consecutive
+   * random leaves that gave no automorphism: the generators found generate
+   * the whole automorphism group only with high probability. The group
+   * size in \a stats is that of the group generated, a lower bound.
+   * The random choices are made by a generator seeded with \a seed.
+   */
+    void find_automorphisms_randomized(Stats& stats,
+                                       void (*hook)(void* user_param,
+                                                    unsigned int n,
+                                                    const unsigned int* aut),
+                                       void* hook_user_param,
+                                       unsigned int nof_fails,
+                                       unsigned long seed = 1);
 };
 
 /**
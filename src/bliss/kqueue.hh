@@ -94,10 +94,13 @@ template <class Type>
 void KQueue<Type>::init(const unsigned int k)
 {
     assert(k > 0);
-    if (entries)
-        free(entries);
-    entries = (Type *)malloc((k + 1) * sizeof(Type));
-    end = entries + k + 1;
+    /* Reuse the buffer if it is large enough */
+    if (!entries || (unsigned int)(end - entries) < k + 1) {
+        if (entries)
+            free(entries);
+        entries = (Type *)malloc((k + 1) * sizeof(Type));
+        end = entries + k + 1;
+    }
     head = entries;
     tail = head;
 }
@@ -141,10 +141,13 @@ template <class Type>
 void KStack<Type>::init(int k)
 {
     assert(k > 0);
-    if (entries)
-        free(entries);
-    kapacity = k;
-    entries = (Type *)malloc((k + 1) * sizeof(Type));
+    /* Reuse the buffer if it is large enough */
+    if (!entries || k > kapacity) {
+        if (entries)
+            free(entries);
+        kapacity = k;
+        entries = (Type *)malloc((k + 1) * sizeof(Type));
+    }
     cursor = entries;
 }
 
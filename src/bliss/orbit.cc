@@ -47,13 +47,15 @@ Orbit::~Orbit()
 void Orbit::init(const unsigned int n)
 {
     assert(n > 0);
-    if (orbits)
-        free(orbits);
-    orbits = (OrbitEntry *)malloc(n * sizeof(OrbitEntry));
-    if (in_orbit)
-        free(in_orbit);
-    in_orbit = (OrbitEntry **)malloc(n * sizeof(OrbitEntry *));
-    nof_elements = n;
+    if (n != nof_elements) {
+        if (orbits)
+            free(orbits);
+        orbits = (OrbitEntry *)malloc(n * sizeof(OrbitEntry));
+        if (in_orbit)
+            free(in_orbit);
+        in_orbit = (OrbitEntry **)malloc(n * sizeof(OrbitEntry *));
+        nof_elements = n;
+    }
 
     reset();
 }
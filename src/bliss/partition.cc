@@ -32,7 +32,6 @@ Partition::Partition()
     in_pos = 0;
     invariant_values = 0;
     cells = 0;
-    free_cells = 0;
     element_to_cell_map = 0;
     graph = 0;
     discrete_cell_count = 0;
@@ -67,44 +66,50 @@ Partition::~Partition()
         free(invariant_values);
         invariant_values = 0;
     }
+    cr_release();
     N = 0;
 }
 
 void Partition::init(const unsigned int M)
 {
     assert(M > 0);
-    N = M;
 
-    if (elements)
-        free(elements);
-    elements = (unsigned int*)malloc(N * sizeof(unsigned int));
+    /* The arrays are only reallocated when the number of elements changes,
+     so that searching the same graph again does not allocate anything */
+    if (M != N) {
+        N = M;
+        if (elements)
+            free(elements);
+        elements = (unsigned int*)malloc(N * sizeof(unsigned int));
+        if (in_pos)
+            free(in_pos);
+        in_pos = (unsigned int**)malloc(N * sizeof(unsigned int*));
+        if (invariant_values)
+            free(invariant_values);
+        invariant_values = (unsigned int*)malloc(N * sizeof(unsigned int));
+        if (cells)
+            free(cells);
+        cells = (Cell*)malloc(N * sizeof(Cell));
+        if (element_to_cell_map)
+            free(element_to_cell_map);
+        element_to_cell_map = (Cell**)malloc(N * sizeof(Cell*));
+        /* Component recursion arrays are reallocated by cr_init() */
+        cr_release();
+    }
+
     for (unsigned int i = 0; i < N; i++)
         elements[i] = i;
-
-    if (in_pos)
-        free(in_pos);
-    in_pos = (unsigned int**)malloc(N * sizeof(unsigned int*));
     for (unsigned int i = 0; i < N; i++)
         in_pos[i] = elements + i;
-
-    if (invariant_values)
-        free(invariant_values);
-    invariant_values = (unsigned int*)malloc(N * sizeof(unsigned int));
     for (unsigned int i = 0; i < N; i++)
         invariant_values[i] = 0;
 
-    if (cells)
-        free(cells);
-    cells = (Cell*)malloc(N * sizeof(Cell));
-
     cells[0].first = 0;
     cells[0].length = N;
     cells[0].max_ival = 0;
     cells[0].max_ival_count = 0;
     cells[0].in_splitting_queue = false;
     cells[0].in_neighbour_heap = false;
-    cells[0].prev = 0;
-    cells[0].next = 0;
     cells[0].next_nonsingleton = 0;
     cells[0].prev_nonsingleton = 0;
     cells[0].split_level = 0;
@@ -124,19 +129,9 @@ void Partition::init(const unsigned int M)
         cells[i].max_ival_count = 0;
         cells[i].in_splitting_queue = false;
         cells[i].in_neighbour_heap = false;
-        cells[i].prev = 0;
-        cells[i].next = (i < N - 1) ? &cells[i + 1] : 0;
         cells[i].next_nonsingleton = 0;
         cells[i].prev_nonsingleton = 0;
     }
-    if (N > 1)
-        free_cells = &cells[1];
-    else
-        free_cells = 0;
-
-    if (element_to_cell_map)
-        free(element_to_cell_map);
-    element_to_cell_map = (Cell**)malloc(N * sizeof(Cell*));
     for (unsigned int i = 0; i < N; i++)
         element_to_cell_map[i] = first_cell;
 
@@ -182,13 +177,16 @@ void Partition::goto_backtrack_point(BacktrackPoint p)
         assert(cell->split_level > dest_refinement_stack_size);
 
         while (cell->split_level > dest_refinement_stack_size) {
-            assert(cell->prev);
-            cell = cell->prev;
+            assert(prev_cell(cell));
+            cell = prev_cell(cell);
         }
-        while (cell->next &&
-               cell->next->split_level > dest_refinement_stack_size) {
+        /* The cells split after the backtrack point are the last ones of
+       the cells array and are freed by popping refinement_stack:
+       only their elements need to be merged back */
+        Cell* next_cell;
+        while ((next_cell = this->next_cell(cell)) &&
+               next_cell->split_level > dest_refinement_stack_size) {
             /* Merge next cell */
-            Cell* const next_cell = cell->next;
             if (cell->length == 1)
                 discrete_cell_count--;
             if (next_cell->length == 1)
@@ -200,15 +198,9 @@ void Partition::goto_backtrack_point(BacktrackPoint p)
                 element_to_cell_map[*ep] = cell;
             /* Update cell parameters */
             cell->length += next_cell->length;
-            if (next_cell->next)
-                next_cell->next->prev = cell;
-            cell->next = next_cell->next;
             /* (Pseudo)free next_cell */
             next_cell->first = 0;
             next_cell->length = 0;
-            next_cell->prev = 0;
-            next_cell->next = free_cells;
-            free_cells = next_cell;
         }
 
     done:
@@ -258,19 +250,13 @@ Partition::Cell* Partition::aux_split_in_two(Partition::Cell* const cell,
     RefInfo i;
 
     /* (Pseudo)allocate new cell */
-    Cell* const new_cell = free_cells;
-    free_cells = new_cell->next;
+    Cell* const new_cell = alloc_cell();
     /* Update new cell parameters */
     new_cell->first = cell->first + first_half_size;
     new_cell->length = cell->length - first_half_size;
-    new_cell->next = cell->next;
-    if (new_cell->next)
-        new_cell->next->prev = new_cell;
-    new_cell->prev = cell;
     new_cell->split_level = refinement_stack.size() + 1;
     /* Update old, splitted cell parameters */
     cell->length = first_half_size;
-    cell->next = new_cell;
     /* CR */
     if (cr_enabled)
         cr_create_at_level_trailed(new_cell->first, cr_get_level(cell->first));
@@ -322,7 +308,7 @@ size_t Partition::print(FILE* const fp, const bool add_newline) const
     size_t r = 0;
     const char* cell_sep = "";
     r += fprintf(fp, "[");
-    for (Cell* cell = first_cell; cell; cell = cell->next) {
+    for (Cell* cell = first_cell; cell; cell = next_cell(cell)) {
         /* Print cell */
         r += fprintf(fp, "%s{", cell_sep);
         cell_sep = ",";
@@ -344,7 +330,7 @@ size_t Partition::print_signature(FILE* const fp, const bool add_newline) const
     size_t r = 0;
     const char* cell_sep = "";
     r += fprintf(fp, "[");
-    for (Cell* cell = first_cell; cell; cell = cell->next) {
+    for (Cell* cell = first_cell; cell; cell = next_cell(cell)) {
         if (cell->is_unit())
             continue;
         //fprintf(fp, "%s%u", cell_sep, cr_cells[cell->first].level);
@@ -400,11 +386,8 @@ Partition::Cell* Partition::sort_and_split_cell1(Partition::Cell* const cell)
 #endif
 
     /* (Pseudo)allocate new cell */
-    Cell* const new_cell = free_cells;
-    free_cells = new_cell->next;
+    Cell* const new_cell = alloc_cell();
 
-#define NEW_SORT1
-#ifdef NEW_SORT1
     unsigned int* ep0 = elements + cell->first;
     unsigned int* ep1 = ep0 + cell->length - cell->max_ival_count;
     if (cell->max_ival_count > cell->length / 2) {
@@ -447,56 +430,13 @@ Partition::Cell* Partition::sort_and_split_cell1(Partition::Cell* const cell)
     /* Update new cell parameters */
     new_cell->first = cell->first + cell->length - cell->max_ival_count;
     new_cell->length = cell->length - (new_cell->first - cell->first);
-    new_cell->next = cell->next;
-    if (new_cell->next)
-        new_cell->next->prev = new_cell;
-    new_cell->prev = cell;
     new_cell->split_level = refinement_stack.size() + 1;
     /* Update old, splitted cell parameters */
     cell->length = new_cell->first - cell->first;
-    cell->next = new_cell;
     /* CR */
     if (cr_enabled)
         cr_create_at_level_trailed(new_cell->first, cr_get_level(cell->first));
 
-#else
-    /* Sort vertices in the cell according to the invariant values */
-    unsigned int* ep0 = elements + cell->first;
-    unsigned int* ep1 = ep0 + cell->length;
-    while (ep1 > ep0) {
-        const unsigned int element = *ep0;
-        const unsigned int ival = invariant_values[element];
-        invariant_values[element] = 0;
-        if (ival == 0) {
-            ep0++;
-        } else {
-            ep1--;
-            *ep0 = *ep1;
-            *ep1 = element;
-            element_to_cell_map[element] = new_cell;
-            in_pos[element] = ep1;
-            in_pos[*ep0] = ep0;
-        }
-    }
-
-    /* Update new cell parameters */
-    new_cell->first = ep1 - elements;
-    new_cell->length = cell->length - (new_cell->first - cell->first);
-    new_cell->next = cell->next;
-    if (new_cell->next)
-        new_cell->next->prev = new_cell;
-    new_cell->prev = cell;
-    new_cell->split_level = cell->split_level;
-    /* Update old, splitted cell parameters */
-    cell->length = new_cell->first - cell->first;
-    cell->next = new_cell;
-    cell->split_level = refinement_stack.size() + 1;
-    /* CR */
-    if (cr_enabled)
-        cr_create_at_level_trailed(new_cell->first, cr_get_level(cell->first));
-
-#endif /* ifdef NEW_SORT1*/
-
     /* Add cell in refinement stack for backtracking */
     {
         RefInfo i;
@@ -886,16 +826,15 @@ void Partition::cr_init()
 
     cr_enabled = true;
 
-    if (cr_cells)
-        free(cr_cells);
-    cr_cells = (CRCell*)malloc(N * sizeof(CRCell));
+    /* Kept by cr_free(), the size is the one of the last init() */
+    if (!cr_cells)
+        cr_cells = (CRCell*)malloc(N * sizeof(CRCell));
     if (!cr_cells) {
         assert(false && "Mem out");
     }
 
-    if (cr_levels)
-        free(cr_levels);
-    cr_levels = (CRCell**)malloc(N * sizeof(CRCell*));
+    if (!cr_levels)
+        cr_levels = (CRCell**)malloc(N * sizeof(CRCell*));
     if (!cr_levels) {
         assert(false && "Mem out");
     }
@@ -907,13 +846,23 @@ void Partition::cr_init()
         cr_cells[i].prev_next_ptr = 0;
     }
 
-    for (const Cell* cell = first_cell; cell; cell = cell->next)
+    for (const Cell* cell = first_cell; cell; cell = next_cell(cell))
         cr_create_at_level_trailed(cell->first, 0);
 
     cr_max_level = 0;
 }
 
 void Partition::cr_free()
+{
+    cr_created_trail.clear();
+    cr_splitted_level_trail.clear();
+    cr_bt_info.clear();
+    cr_max_level = 0;
+
+    cr_enabled = false;
+}
+
+void Partition::cr_release()
 {
     if (cr_cells) {
         free(cr_cells);
@@ -923,13 +872,6 @@ void Partition::cr_free()
         free(cr_levels);
         cr_levels = 0;
     }
-
-    cr_created_trail.clear();
-    cr_splitted_level_trail.clear();
-    cr_bt_info.clear();
-    cr_max_level = 0;
-
-    cr_enabled = false;
 }
 
 unsigned int Partition::cr_split_level(
@@ -53,6 +53,11 @@ class Partition
    public:
     /**
    * \brief Data structure for holding information about a cell in a Partition.
+   *
+   * The cells live in one array, the cell created by the i:th split being
+   * at index i. The cells are not linked in their order in the partition:
+   * the neighbours of a cell are the cells of the elements just before and
+   * after it, see Partition::next_cell and Partition::prev_cell.
    */
     class Cell
     {
@@ -71,12 +76,9 @@ class Partition
 
        public:
         bool in_neighbour_heap;
-        /* Pointer to the next cell, null if this is the last one. */
-        Cell* next;
-        Cell* prev;
+        unsigned int split_level;
         Cell* next_nonsingleton;
         Cell* prev_nonsingleton;
-        unsigned int split_level;
         /** Is this a unit cell? */
         bool is_unit() const
         {
@@ -156,9 +158,13 @@ class Partition
 
    private:
     unsigned int N;
+    /* cells[0..refinement_stack.size()] are in use, the rest are free */
     Cell* cells;
-    Cell* free_cells;
     unsigned int discrete_cell_count;
+    Cell* alloc_cell()
+    {
+        return &cells[refinement_stack.size() + 1];
+    }
 
    public:
     Cell* first_cell;
@@ -173,6 +179,18 @@ class Partition
     {
         return element_to_cell_map[e];
     }
+    /** Get the cell following \a cell, null if it is the last one */
+    Cell* next_cell(const Cell* const cell) const
+    {
+        const unsigned int last = cell->first + cell->length;
+        return last < N ? element_to_cell_map[elements[last]] : 0;
+    }
+    /** Get the cell preceding \a cell, null if it is the first one */
+    Cell* prev_cell(const Cell* const cell) const
+    {
+        return cell->first > 0 ? element_to_cell_map[elements[cell->first - 1]]
+                               : 0;
+    }
     /* in_pos[e] points to the elements array s.t. *in_pos[e] = e  */
     unsigned int** in_pos;
 
@@ -191,7 +209,7 @@ class Partition
    */
     bool is_discrete() const
     {
-        return (free_cells == 0);
+        return (refinement_stack.size() + 1 == N);
     }
 
     unsigned int nof_discrete_cells() const
@@ -227,7 +245,10 @@ class Partition
    * Routines for component recursion
    */
     void cr_init();
+    /* Disables component recursion; the memory is kept for the next
+   * cr_init() and released by cr_release() */
     void cr_free();
+    void cr_release();
     unsigned int cr_get_level(const unsigned int cell_index) const;
     unsigned int cr_split_level(const unsigned int level,
                                 const std::vector<unsigned int>& cells);
@@ -0,0 +1,562 @@
+/******************************************
+Copyright (c) 2024 Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+// Runs every stage of BreakID over a set of CNFs, writes the measurements
+// to CSV and optionally compares them against a stored baseline CSV.
+// Exits with a non-zero status if any instance regressed past the tolerance.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "breakid.hpp"
+#include "cnf_generators.hpp"
+#include "time_mem.h"
+#include "argparse.hpp"
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#endif
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::string;
+using std::vector;
+using std::istringstream;
+using BID::BLit;
+namespace fs = std::filesystem;
+
+argparse::ArgumentParser program = argparse::ArgumentParser("breakid-bench");
+string out_fname = "bench.csv";
+string baseline_fname;
+string list_fname;
+double tolerance = 0.0;
+double perf_tolerance = 0.25;
+double min_time = 0.1;
+int64_t steps_lim = std::numeric_limits<int64_t>::max();
+BID::Detector detector = BID::Detector::bliss;
+bool shatter = false;
+uint32_t verbosity = 1;
+
+///One row of the CSV
+struct BenchResult {
+    string instance;
+    vector<double> vals;
+};
+
+///How a column is judged when comparing against the baseline
+enum class Check {
+    perf, ///< may only grow by perf_tolerance (time, memory)
+    exact ///< deterministic output, may only deviate by tolerance
+};
+
+struct Column {
+    const char* name;
+    Check check;
+};
+
+///Index of each column in BenchResult::vals, in the order of columns[]
+enum Col {
+    col_vars,
+    col_clauses,
+    col_t_load,
+    col_t_detect,
+    col_t_subgroups,
+    col_t_break,
+    col_t_total,
+    col_peak_mem,
+    col_generators,
+    col_subgroups,
+    col_matrices,
+    col_row_swaps,
+    col_brk_cls,
+    col_aux_vars,
+    nb_columns
+};
+
+static const Column columns[] = {
+    {"vars", Check::exact},
+    {"clauses", Check::exact},
+    {"t_load", Check::perf},
+    {"t_detect", Check::perf},
+    {"t_subgroups", Check::perf},
+    {"t_break", Check::perf},
+    {"t_total", Check::perf},
+    {"peak_mem_mb", Check::perf},
+    {"generators", Check::exact},
+    {"subgroups", Check::exact},
+    {"matrices", Check::exact},
+    {"row_swaps", Check::exact},
+    {"brk_cls", Check::exact},
+    {"aux_vars", Check::exact},
+};
+static_assert(sizeof(columns)/sizeof(columns[0]) == nb_columns,
+              "one name per column of Col");
+
+void add_options()
+{
+    program.add_argument("-h", "--help")
+        .help("Print help")
+        .default_value(false);
+    program.add_argument("--verb")
+        .action([&](const auto& a) {verbosity = std::atoi(a.c_str());})
+        .default_value(verbosity)
+        .help("[0-2] Verbosity");
+    program.add_argument("-o", "--out")
+        .action([&](const auto& a) {out_fname = a;})
+        .default_value(out_fname)
+        .help("Write the measurements to this CSV file");
+    program.add_argument("--baseline")
+        .action([&](const auto& a) {baseline_fname = a;})
+        .default_value(baseline_fname)
+        .help("Compare against this CSV, as previously written with --out");
+    program.add_argument("--list")
+        .action([&](const auto& a) {list_fname = a;})
+        .default_value(list_fname)
+        .help("File listing one CNF per line, used in addition to the positional files");
+    program.add_argument("--tol")
+        .action([&](const auto& a) {tolerance = std::atof(a.c_str());})
+        .default_value(tolerance)
+        .help("Relative tolerance on generator, matrix and clause counts");
+    program.add_argument("--perftol")
+        .action([&](const auto& a) {perf_tolerance = std::atof(a.c_str());})
+        .default_value(perf_tolerance)
+        .help("Relative slowdown or memory growth allowed before failing");
+    program.add_argument("--mintime")
+        .action([&](const auto& a) {min_time = std::atof(a.c_str());})
+        .default_value(min_time)
+        .help("Timings below this many seconds are never counted as regressions");
+    program.add_argument("-t")
+        .action([&](const auto& a) {
+                steps_lim = std::atoll(a.c_str());
+                steps_lim *= 1000LL;
+                })
+        .default_value(steps_lim)
+        .help("Upper limit on computing steps spent in kilo-steps, per instance");
+    program.add_argument("--detector")
+        .action([&](const auto& a) {
+                uint32_t i = 0;
+                while (i < BID::nb_detectors
+                    && a != BID::to_string((BID::Detector)i)) i++;
+                if (i == BID::nb_detectors) {
+                    cerr << "ERROR: unknown detector '" << a << "'" << endl;
+                    exit(-1);
+                }
+                detector = (BID::Detector)i;
+                })
+        .default_value(string(BID::to_string(detector)))
+        .help("Symmetry detection engine, run the same instances with each one"
+              " to compare them");
+    program.add_argument("--small")
+        .action([&](const auto& a) {shatter = std::atoi(a.c_str());})
+        .default_value(shatter)
+        .help("Break with Shatter's encoding, run the same instances with and"
+              " without it to compare the formulas");
+    program.add_argument("files").remaining().help(
+        "CNF files, directories containing them, or generated instances"
+        " such as gen:php:9, see breakid-gen --help");
+}
+
+static uint32_t readCNF(const string& filename, vector<vector<BLit>>& clauses)
+{
+    std::ifstream file(filename);
+    if (!file) {
+        cerr << "ERROR: cannot open CNF file " << filename << endl;
+        exit(-1);
+    }
+
+    uint32_t nVars = 0;
+    string line;
+    vector<BLit> inclause;
+    while (getline(file, line)) {
+        if (line.size() == 0 || line.front() == 'c') {
+            // do nothing, this is a comment line
+        } else if (line.front() == 'p') {
+            istringstream iss(line.substr(6));
+            uint32_t nbClauses;
+            iss >> nVars >> nbClauses;
+            clauses.reserve(nbClauses);
+        } else {
+            istringstream iss(line);
+            int l;
+            while (iss >> l) {
+                if (l == 0) {
+                    if (inclause.empty()) {
+                        cerr << "ERROR: " << filename << " contains an empty clause." << endl;
+                        exit(-1);
+                    }
+                    clauses.push_back(inclause);
+                    inclause.clear();
+                } else {
+                    if ((uint32_t)abs(l) > nVars) nVars = abs(l);
+                    inclause.push_back(BLit(abs(l)-1, l < 0));
+                }
+            }
+        }
+    }
+    return nVars;
+}
+
+///Instances named "gen:family:params..." are generated in memory
+static uint32_t load_instance(const string& name, vector<vector<BLit>>& clauses)
+{
+    if (name.compare(0, 4, "gen:") != 0) return readCNF(name, clauses);
+
+    string family;
+    vector<uint64_t> params;
+    BID::gen::VectorSink sink;
+    bool ok;
+    try {
+        ok = BID::gen::parse_spec(name.substr(4), family, params)
+            && BID::gen::generate(family, params, 1, sink);
+    } catch (const std::invalid_argument& err) {
+        cerr << "ERROR: " << name << ": " << err.what() << endl;
+        exit(-1);
+    }
+    if (!ok) {
+        cerr << "ERROR: bad generated instance " << name << ", the families are:" << endl
+        << BID::gen::families_help();
+        exit(-1);
+    }
+    clauses.swap(sink.clauses);
+    return sink.nVars;
+}
+
+static double memMB()
+{
+    double vm_usage;
+    return (double)memUsedTotal(vm_usage)/(1024.0*1024.0);
+}
+
+static BenchResult run_instance_inproc(const string& fname)
+{
+    typedef std::chrono::steady_clock clk;
+    auto secs = [](clk::time_point a, clk::time_point b) {
+        return std::chrono::duration<double>(b - a).count();
+    };
+    if (verbosity) cout << "c Running " << fname << endl;
+
+    // Peak memory is sampled at the stage boundaries, the forking
+    // run_instance() replaces it with the exact value
+    double peak_mem = memMB();
+    auto t0 = clk::now();
+    vector<vector<BLit>> cls;
+    uint32_t nVars = load_instance(fname, cls);
+
+    BID::BreakID breakid;
+    breakid.set_verbosity(verbosity >= 2 ? 1 : 0);
+    breakid.set_steps_lim(steps_lim);
+    breakid.set_detector(detector);
+    breakid.set_useShatterTranslation(shatter);
+    breakid.start_dynamic_cnf(nVars);
+    for (auto& cl: cls) breakid.add_clause(cl.data(), cl.size());
+    auto t1 = clk::now();
+    peak_mem = std::max(peak_mem, memMB());
+
+    breakid.end_dynamic_cnf();
+    auto t2 = clk::now();
+    peak_mem = std::max(peak_mem, memMB());
+    // must be read before detect_subgroups() distributes them
+    const uint32_t nb_gens = breakid.get_num_generators();
+
+    breakid.detect_subgroups();
+    auto t3 = clk::now();
+    peak_mem = std::max(peak_mem, memMB());
+
+    breakid.break_symm();
+    auto t4 = clk::now();
+    peak_mem = std::max(peak_mem, memMB());
+
+    BenchResult r;
+    r.instance = fname;
+    r.vals.resize(nb_columns);
+    r.vals[col_vars] = nVars;
+    r.vals[col_clauses] = cls.size();
+    r.vals[col_t_load] = secs(t0, t1);
+    r.vals[col_t_detect] = secs(t1, t2);
+    r.vals[col_t_subgroups] = secs(t2, t3);
+    r.vals[col_t_break] = secs(t3, t4);
+    r.vals[col_t_total] = secs(t0, t4);
+    r.vals[col_peak_mem] = peak_mem;
+    r.vals[col_generators] = nb_gens;
+    r.vals[col_subgroups] = breakid.get_num_subgroups();
+    r.vals[col_matrices] = breakid.get_num_matrices();
+    r.vals[col_row_swaps] = breakid.get_num_row_swaps();
+    r.vals[col_brk_cls] = breakid.get_num_break_cls();
+    r.vals[col_aux_vars] = breakid.get_num_aux_vars();
+    return r;
+}
+
+#if !defined(_WIN32)
+///Runs each instance in a forked child, so that the peak memory is that
+///of the instance alone, not the high-water mark of all instances so far
+static BenchResult run_instance(const string& fname)
+{
+    int fds[2];
+    if (pipe(fds) != 0) return run_instance_inproc(fname);
+    cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return run_instance_inproc(fname);
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        BenchResult r = run_instance_inproc(fname);
+        const size_t sz = r.vals.size()*sizeof(double);
+        bool ok = write(fds[1], r.vals.data(), sz) == (ssize_t)sz;
+        close(fds[1]);
+        cout.flush();
+        _exit(ok ? 0 : 1);
+    }
+
+    close(fds[1]);
+    BenchResult r;
+    r.instance = fname;
+    r.vals.resize(nb_columns);
+    const size_t sz = r.vals.size()*sizeof(double);
+    size_t got = 0;
+    while (got < sz) {
+        ssize_t n = read(fds[0], (char*)r.vals.data() + got, sz - got);
+        if (n <= 0) break;
+        got += n;
+    }
+    close(fds[0]);
+
+    int status;
+    struct rusage ru;
+    wait4(pid, &status, 0, &ru);
+    if (got != sz || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        cerr << "ERROR: benchmarking " << fname << " failed" << endl;
+        exit(-1);
+    }
+#if defined(__APPLE__)
+    r.vals[col_peak_mem] = (double)ru.ru_maxrss/(1024.0*1024.0);
+#else
+    r.vals[col_peak_mem] = (double)ru.ru_maxrss/1024.0;
+#endif
+    return r;
+}
+#else
+static BenchResult run_instance(const string& fname)
+{
+    return run_instance_inproc(fname);
+}
+#endif
+
+static void write_csv(const string& fname, const vector<BenchResult>& results)
+{
+    std::ofstream out(fname);
+    if (!out) {
+        cerr << "ERROR: cannot write " << fname << endl;
+        exit(-1);
+    }
+    out << "instance";
+    for (const auto& c: columns) out << "," << c.name;
+    out << "\n";
+    out << std::setprecision(6);
+    for (const auto& r: results) {
+        out << r.instance;
+        for (auto v: r.vals) out << "," << v;
+        out << "\n";
+    }
+}
+
+static std::map<string, BenchResult> read_csv(const string& fname)
+{
+    std::ifstream in(fname);
+    if (!in) {
+        cerr << "ERROR: cannot read baseline " << fname << endl;
+        exit(-1);
+    }
+
+    // map baseline columns by name, so that adding columns keeps old baselines usable
+    string line;
+    getline(in, line);
+    vector<int> col_map;
+    {
+        istringstream iss(line);
+        string name;
+        getline(iss, name, ',');
+        while (getline(iss, name, ',')) {
+            int at = -1;
+            for (size_t i = 0; i < nb_columns; i++) {
+                if (name == columns[i].name) at = i;
+            }
+            col_map.push_back(at);
+        }
+    }
+
+    std::map<string, BenchResult> ret;
+    while (getline(in, line)) {
+        if (line.empty()) continue;
+        istringstream iss(line);
+        BenchResult r;
+        getline(iss, r.instance, ',');
+        r.vals.resize(nb_columns, std::nan(""));
+        string val;
+        for (size_t i = 0; i < col_map.size() && getline(iss, val, ','); i++) {
+            if (col_map[i] >= 0) r.vals[col_map[i]] = std::atof(val.c_str());
+        }
+        ret[r.instance] = r;
+    }
+    return ret;
+}
+
+///Returns the number of regressions found
+static uint32_t compare(
+    const vector<BenchResult>& results,
+    const std::map<string, BenchResult>& baseline)
+{
+    uint32_t regressions = 0;
+    for (const auto& r: results) {
+        auto it = baseline.find(r.instance);
+        if (it == baseline.end()) {
+            cout << "c [bench] " << r.instance << " not in baseline, skipping" << endl;
+            continue;
+        }
+        const BenchResult& b = it->second;
+        for (size_t i = 0; i < nb_columns; i++) {
+            const double now = r.vals[i];
+            const double old = b.vals[i];
+            if (std::isnan(old)) continue;
+
+            bool bad;
+            if (columns[i].check == Check::perf) {
+                const bool is_time = columns[i].name[0] == 't';
+                bad = now > old*(1.0+perf_tolerance)
+                    && (!is_time || now - old > min_time);
+            } else {
+                bad = std::abs(now - old) > std::abs(old)*tolerance;
+            }
+            if (bad) {
+                regressions++;
+                cout << "c [bench] REGRESSION " << r.instance << " "
+                << columns[i].name << ": " << old << " -> " << now << endl;
+            }
+        }
+    }
+    for (const auto& b: baseline) {
+        bool found = false;
+        for (const auto& r: results) found |= r.instance == b.first;
+        if (!found) cout << "c [bench] baseline instance " << b.first << " was not run" << endl;
+    }
+    return regressions;
+}
+
+static void collect(const string& path, vector<string>& files)
+{
+    if (path.compare(0, 4, "gen:") == 0) {
+        files.push_back(path);
+    } else if (fs::is_directory(path)) {
+        vector<string> found;
+        for (const auto& e: fs::recursive_directory_iterator(path)) {
+            if (e.is_regular_file() && e.path().extension() == ".cnf") {
+                found.push_back(e.path().lexically_normal().string());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    } else {
+        files.push_back(fs::path(path).lexically_normal().string());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    add_options();
+    try {
+        program.parse_args(argc, argv);
+        if (program.is_used("--help")) {
+            cout << "Benchmark harness for BreakID." << endl;
+            cout << "breakid-bench [options] cnf-files-or-dirs" << endl << endl;
+            cout << program << endl;
+            std::exit(0);
+        }
+    }
+    catch (const std::exception& err) {
+        std::cerr << err.what() << endl;
+        std::cerr << program;
+        exit(-1);
+    }
+
+    vector<string> files;
+    try {
+        for (const auto& f: program.get<std::vector<std::string>>("files")) {
+            collect(f, files);
+        }
+    } catch (std::logic_error&) {
+        // no positional files given
+    }
+    if (!list_fname.empty()) {
+        std::ifstream list(list_fname);
+        if (!list) {
+            cerr << "ERROR: cannot read list file " << list_fname << endl;
+            exit(-1);
+        }
+        string line;
+        while (getline(list, line)) {
+            if (!line.empty() && line.front() != '#') collect(line, files);
+        }
+    }
+    if (files.empty()) {
+        cerr << "ERROR: no CNF files given" << endl;
+        exit(-1);
+    }
+
+    vector<BenchResult> results;
+    for (const auto& f: files) {
+        results.push_back(run_instance(f));
+        if (verbosity) {
+            // formatted apart, so that the later output keeps the defaults
+            const auto& r = results.back();
+            std::ostringstream summary;
+            summary << std::setprecision(2) << std::fixed
+            << "T: " << r.vals[col_t_total] << " s  mem: " << r.vals[col_peak_mem] << " MB"
+            << std::setprecision(0)
+            << "  gens: " << r.vals[col_generators] << "  matrices: " << r.vals[col_matrices]
+            << "  brk cls: " << r.vals[col_brk_cls];
+            cout << "c [bench] " << summary.str() << endl;
+        }
+    }
+    write_csv(out_fname, results);
+    if (verbosity) cout << "c [bench] results written to " << out_fname << endl;
+
+    if (!baseline_fname.empty()) {
+        uint32_t regressions = compare(results, read_csv(baseline_fname));
+        cout << "c [bench] regressions: " << regressions << endl;
+        if (regressions > 0) return 1;
+    }
+    return 0;
+}
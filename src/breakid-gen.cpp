@@ -0,0 +1,180 @@
+/******************************************
+Copyright (c) 2024 Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+// Writes synthetic symmetric CNF families as DIMACS, or feeds them straight
+// into BreakID with --run, for scaling studies without external files.
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "breakid.hpp"
+#include "cnf_generators.hpp"
+#include "time_mem.h"
+#include "argparse.hpp"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::string;
+using std::vector;
+
+argparse::ArgumentParser program = argparse::ArgumentParser("breakid-gen");
+string out_fname;
+uint64_t seed = 1;
+int64_t steps_lim = std::numeric_limits<int64_t>::max();
+uint32_t verbosity = 0;
+
+void add_options()
+{
+    program.add_argument("-h", "--help")
+        .help("Print help")
+        .default_value(false);
+    program.add_argument("--verb")
+        .action([&](const auto& a) {verbosity = std::atoi(a.c_str());})
+        .default_value(verbosity)
+        .help("[0-10] Verbosity of BreakID, with --run");
+    program.add_argument("-o", "--out")
+        .action([&](const auto& a) {out_fname = a;})
+        .default_value(out_fname)
+        .help("Write the DIMACS CNF to this file instead of standard output");
+    program.add_argument("--seed")
+        .action([&](const auto& a) {seed = std::strtoull(a.c_str(), nullptr, 10);})
+        .default_value(seed)
+        .help("Seed of the randomized families");
+    program.add_argument("--run")
+        .flag()
+        .help("Do not write DIMACS, run BreakID on the generated clauses and print statistics");
+    program.add_argument("-t")
+        .action([&](const auto& a) {
+                steps_lim = std::atoll(a.c_str());
+                steps_lim *= 1000LL;
+                })
+        .default_value(steps_lim)
+        .help("Upper limit on computing steps spent in kilo-steps, with --run");
+    program.add_argument("args").remaining().help("family followed by its parameters");
+}
+
+static void run(const string& family, const vector<uint64_t>& params)
+{
+    BID::BreakID breakid;
+    breakid.set_verbosity(verbosity);
+    breakid.set_steps_lim(steps_lim);
+
+    double t = cpuTime();
+    BID::gen::BreakIDSink sink(breakid);
+    if (!BID::gen::generate(family, params, seed, sink)) {
+        cerr << "ERROR: unknown family or wrong number of parameters:" << endl
+        << BID::gen::families_help();
+        exit(-1);
+    }
+    cout << "c [gen] generated in " << (cpuTime()-t) << " s" << endl;
+
+    t = cpuTime();
+    breakid.end_dynamic_cnf();
+    cout << "c [gen] generators: " << breakid.get_num_generators()
+    << " T: " << (cpuTime()-t) << " s" << endl;
+
+    t = cpuTime();
+    breakid.detect_subgroups();
+    breakid.break_symm();
+    cout << "c [gen] subgroups: " << breakid.get_num_subgroups()
+    << " matrices: " << breakid.get_num_matrices()
+    << " breaking clauses: " << breakid.get_num_break_cls()
+    << " aux vars: " << breakid.get_num_aux_vars()
+    << " T: " << (cpuTime()-t) << " s" << endl;
+}
+
+static void write_dimacs(const string& family, const vector<uint64_t>& params)
+{
+    FILE* out = stdout;
+    if (!out_fname.empty()) {
+        out = fopen(out_fname.c_str(), "wb");
+        if (!out) {
+            cerr << "ERROR: cannot write " << out_fname << endl;
+            exit(-1);
+        }
+    }
+    {
+        BID::gen::DimacsSink sink(out);
+        if (!BID::gen::generate(family, params, seed, sink)) {
+            cerr << "ERROR: unknown family or wrong number of parameters:" << endl
+            << BID::gen::families_help();
+            exit(-1);
+        }
+    }
+    if (out != stdout) fclose(out);
+}
+
+int main(int argc, char *argv[])
+{
+    add_options();
+    vector<string> args;
+    try {
+        program.parse_args(argc, argv);
+        if (program.is_used("--help")) {
+            cout << "Generator of symmetric CNF families." << endl;
+            cout << "breakid-gen [options] family params..." << endl << endl;
+            cout << "Families:" << endl << BID::gen::families_help() << endl;
+            cout << program << endl;
+            std::exit(0);
+        }
+    }
+    catch (const std::exception& err) {
+        std::cerr << err.what() << endl;
+        std::cerr << program;
+        exit(-1);
+    }
+    try {
+        args = program.get<std::vector<std::string>>("args");
+    }
+    catch (const std::logic_error&) {
+        // no positional arguments given, reported below
+    }
+
+    // same syntax as the "gen:" instances of breakid-bench
+    string spec;
+    for (const auto& a: args) spec += (spec.empty() ? "" : ":") + a;
+    string family;
+    vector<uint64_t> params;
+    if (!BID::gen::parse_spec(spec, family, params)) {
+        cerr << "ERROR: give a family and its non-negative integer parameters:" << endl
+        << BID::gen::families_help();
+        exit(-1);
+    }
+
+    try {
+        if (program["--run"] == true) {
+            run(family, params);
+        } else {
+            write_dimacs(family, params);
+        }
+    }
+    catch (const std::invalid_argument& err) {
+        cerr << "ERROR: " << err.what() << endl;
+        exit(-1);
+    }
+    return 0;
+}
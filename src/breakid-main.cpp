@@ -71,12 +71,29 @@ void add_options()
         .help("Use/don't use construction of additional binary symmetry breaking clauses"
                 "based on stabilizer subgroups");
 
+    program.add_argument("--redundant")
+        .action([&](const auto& a) {conf.removeRedundantGens = std::atoi(a.c_str());})
+        .default_value(conf.removeRedundantGens)
+        .help("Remove the generators that are products of the others before breaking:"
+                " fewer clauses, but a weaker breaking formula");
+
     program.add_argument("-s")
         .action([&](const auto& a) {conf.symBreakingFormLength = std::atoi(a.c_str());})
         .default_value(conf.symBreakingFormLength)
         .help("Limit the size of the constructed symmetry breaking"
             " formulas, measured as the number of auxiliary variables");
 
+    program.add_argument("--budget")
+        .action([&](const auto& a) {conf.breakingClauseBudget = std::atoll(a.c_str());})
+        .default_value(conf.breakingClauseBudget)
+        .help("Limit the total number of symmetry breaking clauses, -1 for no limit;"
+            " the generators expected to break the most are broken first");
+
+    program.add_argument("--auxbudget")
+        .action([&](const auto& a) {conf.breakingAuxBudget = std::atoll(a.c_str());})
+        .default_value(conf.breakingAuxBudget)
+        .help("Limit the total number of auxiliary variables, -1 for no limit");
+
     program.add_argument("-t")
         .action([&](const auto& a) {
                 conf.steps_lim = std::atoll(a.c_str());
@@ -96,6 +113,68 @@ void add_options()
         .help("Enable/disable relaxing constraints on auxiliary encoding"
                 "variables, use longer encoding instead");
 
+    program.add_argument("--split")
+        .action([&](const auto& a) {
+                if (a == "auto") {
+                    conf.autoSplitHeuristic = true;
+                    return;
+                }
+                uint32_t i = 0;
+                while (i < BID::nb_split_heuristics
+                    && a != BID::to_string((BID::SplitHeuristic)i)) i++;
+                if (i == BID::nb_split_heuristics) {
+                    cerr << "ERROR: unknown splitting heuristic '" << a << "'" << endl;
+                    exit(-1);
+                }
+                conf.splitHeuristic = (BID::SplitHeuristic)i;
+                })
+        .default_value(string(BID::to_string(conf.splitHeuristic)))
+        .help("Splitting heuristic of the symmetry search: f, fs, fl, fm, fsm, flm,"
+                " or auto to choose from features of the graph");
+
+    program.add_argument("--portfolio")
+        .action([&](const auto& a) {conf.usePortfolio = std::atoi(a.c_str());})
+        .default_value(conf.usePortfolio)
+        .help("Race all splitting heuristics on separate threads and keep the first"
+                " to finish, its name is printed so that it can be given to --split");
+
+    program.add_argument("--threads")
+        .action([&](const auto& a) {conf.searchThreads = std::max(1, std::atoi(a.c_str()));})
+        .default_value(conf.searchThreads)
+        .help("Number of threads of the symmetry search. Only the elements of the"
+                " first target cell but the first are searched in parallel, the"
+                " stabilizer of the first one sequentially");
+
+    program.add_argument("--detector")
+        .action([&](const auto& a) {
+                uint32_t i = 0;
+                while (i < BID::nb_detectors
+                    && a != BID::to_string((BID::Detector)i)) i++;
+                if (i == BID::nb_detectors) {
+                    cerr << "ERROR: unknown detector '" << a << "'" << endl;
+                    exit(-1);
+                }
+                conf.detector = (BID::Detector)i;
+                })
+        .default_value(string(BID::to_string(conf.detector)))
+        .help("Symmetry detection engine: bliss (exhaustive search), random, or refine,"
+                " which only estimates the orbits, without search, and breaks nothing");
+
+    program.add_argument("--random")
+        .action([&](const auto& a) {
+                const int fails = std::atoi(a.c_str());
+                if (fails <= 0) {
+                    conf.detector = BID::Detector::bliss;
+                    return;
+                }
+                conf.detector = BID::Detector::random;
+                conf.randomizedFails = fails;
+                })
+        .default_value(0)
+        .help("Randomized symmetry search instead of the exhaustive one, stopping after"
+                " this many consecutive random symmetries that were already found."
+                " Faster on large graphs, but may miss symmetries. 0 = exhaustive search");
+
     program.add_argument("files").remaining().help("input and optionally file");
 }
 
@@ -179,9 +258,19 @@ int main(int argc, char *argv[])
     breakid.set_useShatterTranslation(conf.useShatterTranslation);
     breakid.set_useFullTranslation(conf.useFullTranslation);
     breakid.set_symBreakingFormLength(conf.symBreakingFormLength);
+    breakid.set_removeRedundantGens(conf.removeRedundantGens);
+    breakid.set_breakingBudget(conf.breakingClauseBudget, conf.breakingAuxBudget);
     breakid.set_verbosity(conf.verbosity);
     breakid.set_verbosity(conf.verbosity);
     breakid.set_steps_lim(conf.steps_lim);
+    breakid.set_splitHeuristic(conf.splitHeuristic);
+    breakid.set_usePortfolio(conf.usePortfolio);
+    breakid.set_autoSplitHeuristic(conf.autoSplitHeuristic);
+    breakid.set_searchThreads(conf.searchThreads);
+    breakid.set_detector(conf.detector);
+    if (conf.detector == BID::Detector::random) {
+        breakid.set_randomizedSearch(conf.randomizedFails);
+    }
 
     std::string in_fname;
     std::string out_fname;
@@ -228,6 +317,33 @@ int main(int argc, char *argv[])
         << endl;
     }
     if (conf.verbosity >= 1) cout << "c Num generators: " << breakid.get_num_generators() << endl;
+    if (conf.verbosity >= 1 && breakid.get_group_size_approx() > 0) {
+        cout << "c Group size (approx): "
+        << std::setprecision(6) << std::defaultfloat
+        << breakid.get_group_size_approx() << endl;
+    }
+    if (conf.detector == BID::Detector::refine) {
+        // cells of the equitable partition, a superset of the orbits
+        auto orbits = breakid.get_approx_orbits();
+        size_t lits = 0;
+        size_t largest = 0;
+        for (const auto& o: orbits) {
+            lits += o.size();
+            largest = std::max(largest, o.size());
+        }
+        cout << "c [refine] approx orbits: " << orbits.size()
+        << " literals in them: " << lits
+        << " largest: " << largest
+        << " T: " << (cpuTime()-myTime) << " s" << endl;
+        cout << "c [refine] " << (orbits.empty() ? "no symmetry" : "may be symmetric") << endl;
+        if (conf.verbosity >= 2) {
+            for (const auto& o: orbits) {
+                cout << "c [refine] orbit:";
+                for (const auto& l: o) cout << " " << l;
+                cout << endl;
+            }
+        }
+    }
     if (conf.verbosity >= 2) breakid.print_generators(cout);
 
     ////////////////
@@ -0,0 +1,389 @@
+/******************************************
+Copyright (c) 2024 Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+// Microbenchmarks for the algebra and breaking hot paths, on synthetic
+// permutations of controlled support size and cycle structure.
+// Every benchmark takes {nb. of permuted variables, cycle length} as
+// arguments; the support of a permutation is twice the variable count,
+// as each variable cycle is mirrored on the negated literals.
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <numeric>
+#include <random>
+
+#include "Algebraic.hpp"
+#include "Breaking.hpp"
+#include "Theory.hpp"
+#include "config.hpp"
+
+using std::make_shared;
+
+static Config* make_conf(uint32_t nVars)
+{
+    static Config conf;
+    conf = Config();
+    conf.nVars = nVars;
+    conf.verbosity = 0;
+    return &conf;
+}
+
+///Permutation moving variables [offs, offs+nvars) in cycles of length cyc.
+///A trailing partial cycle is shorter than cyc.
+static shared_ptr<Permutation> make_perm(
+    Config* conf, uint32_t nvars, uint32_t cyc, uint32_t offs = 0)
+{
+    auto p = make_shared<Permutation>(conf);
+    for (uint32_t start = 0; start < nvars; start += cyc) {
+        const uint32_t len = std::min(cyc, nvars - start);
+        if (len < 2) break;
+        vector<BLit> pos;
+        vector<BLit> neg;
+        for (uint32_t i = 0; i < len; i++) {
+            pos.push_back(BLit(offs + start + i, false));
+            neg.push_back(BLit(offs + start + i, true));
+        }
+        p->addCycle(pos);
+        p->addCycle(neg);
+    }
+    return p;
+}
+
+static void bm_getImage(benchmark::State& state)
+{
+    const uint32_t nvars = state.range(0);
+    Config* conf = make_conf(2*nvars);
+    auto p = make_perm(conf, nvars, state.range(1));
+
+    std::mt19937 rnd(42);
+    vector<BLit> lits;
+    for (uint32_t i = 0; i < 4096; i++) {
+        lits.push_back(BLit(rnd() % (2*nvars), rnd() & 1));
+    }
+    size_t at = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(p->getImage(lits[at]));
+        at = (at + 1) & 4095;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void bm_getCycleReprs(benchmark::State& state)
+{
+    const uint32_t nvars = state.range(0);
+    Config* conf = make_conf(nvars);
+    auto tmpl = make_perm(conf, nvars, state.range(1));
+    for (auto _ : state) {
+        // cycle representatives are cached, so measure on a fresh copy
+        state.PauseTiming();
+        Permutation p(*tmpl);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(p.getCycleReprs().size());
+    }
+    state.SetItemsProcessed(state.iterations()*tmpl->supportSize());
+}
+
+///Permutation moving variables [0, nvars) in cycles of lengths cyc, 2*cyc
+///and 3*cyc in turn, so that its cycles have several prime factorizations
+static shared_ptr<Permutation> make_mixed_perm(
+    Config* conf, uint32_t nvars, uint32_t cyc)
+{
+    auto p = make_shared<Permutation>(conf);
+    uint32_t start = 0;
+    for (uint32_t len = cyc; start + len <= nvars; len = len % (3*cyc) + cyc) {
+        vector<BLit> pos;
+        for (uint32_t i = 0; i < len; i++) {
+            pos.push_back(BLit(start + i, false));
+        }
+        p->addCycle(pos);
+        start += len;
+    }
+    return p;
+}
+
+///Whether q = p^k for some k: q rotates every cycle of p by some r_c, and
+///the r_c agree modulo the gcd of any two cycle lengths
+static bool isPowerOf(const Permutation& q, const Permutation& p)
+{
+    for (auto l : q.domain) {
+        if (p.getImage(l) == l) return false;
+    }
+    std::map<size_t, size_t> lenToRot;
+    vector<BLit> cycle;
+    for (auto l : p.getCycleReprs()) {
+        p.getCycle(l, cycle);
+        const size_t len = cycle.size();
+        const BLit img = q.getImage(cycle[0]);
+        size_t rot = 0;
+        while (rot < len && cycle[rot] != img) rot++;
+        if (rot == len) return false;
+        for (size_t i = 0; i < len; i++) {
+            if (q.getImage(cycle[i]) != cycle[(i + rot) % len]) return false;
+        }
+        auto it = lenToRot.find(len);
+        if (it != lenToRot.end() && it->second != rot) return false;
+        lenToRot[len] = rot;
+    }
+    for (const auto& a : lenToRot) {
+        for (const auto& b : lenToRot) {
+            const size_t g = std::gcd(a.first, b.first);
+            if (a.second % g != b.second % g) return false;
+        }
+    }
+    return true;
+}
+
+static void bm_addPrimeSplitToVector(benchmark::State& state)
+{
+    const uint32_t nvars = state.range(0);
+    Config* conf = make_conf(nvars);
+    auto tmpl = make_perm(conf, nvars, state.range(1));
+    vector<shared_ptr<Permutation> > out;
+    for (const auto& p : {tmpl, make_mixed_perm(conf, nvars, state.range(1))}) {
+        out.clear();
+        Permutation(*p).addPrimeSplitToVector(out);
+        for (const auto& q : out) {
+            if (!isPowerOf(*q, *p)) {
+                state.SkipWithError("split permutation is not a power of its input");
+                return;
+            }
+        }
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        Permutation p(*tmpl);
+        out.clear();
+        state.ResumeTiming();
+        p.addPrimeSplitToVector(out);
+        benchmark::DoNotOptimize(out.size());
+    }
+    state.SetItemsProcessed(state.iterations()*tmpl->supportSize());
+}
+
+///Builds a CNF on nvars variables that is invariant under make_perm(nvars, cyc):
+///a binary clause between consecutive variables of each cycle, plus
+///a ternary clause over each cycle orbit of three consecutive variables.
+static OnlCNF* make_cnf(Config* conf, uint32_t nvars, uint32_t cyc)
+{
+    OnlCNF* cnf = new OnlCNF(conf);
+    for (uint32_t start = 0; start < nvars; start += cyc) {
+        const uint32_t len = std::min(cyc, nvars - start);
+        if (len < 2) break;
+        for (uint32_t i = 0; i < len; i++) {
+            BLit cl[3] = {
+                BLit(start + i, false),
+                BLit(start + (i+1) % len, true),
+                BLit(start + (i+2) % len, false)
+            };
+            if (len >= 3) cnf->add_clause(cl, 3);
+            cnf->add_clause(cl, 2);
+        }
+    }
+    return cnf;
+}
+
+///Loads the clauses of make_cnf() one by one, or at once from a flat buffer
+static void addClauses(benchmark::State& state, bool bulk)
+{
+    const uint32_t nvars = state.range(0);
+    const uint32_t cyc = state.range(1);
+    Config* conf = make_conf(nvars);
+    vector<BLit> lits;
+    vector<uint32_t> offsets(1, 0);
+    for (uint32_t start = 0; start + 1 < nvars; start += cyc) {
+        const uint32_t len = std::min(cyc, nvars - start);
+        for (uint32_t i = 0; i < len && len >= 2; i++) {
+            lits.push_back(BLit(start + i, false));
+            lits.push_back(BLit(start + (i+1) % len, true));
+            if (len >= 3) lits.push_back(BLit(start + (i+2) % len, false));
+            offsets.push_back(lits.size());
+        }
+    }
+    const size_t nbClauses = offsets.size() - 1;
+    for (auto _ : state) {
+        state.PauseTiming();
+        OnlCNF* cnf = new OnlCNF(conf);
+        state.ResumeTiming();
+        if (bulk) {
+            cnf->add_clauses(lits.data(), offsets.data(), nbClauses);
+        } else {
+            for (size_t i = 0; i < nbClauses; i++) {
+                cnf->add_clause(lits.data() + offsets[i], offsets[i+1] - offsets[i]);
+            }
+        }
+        benchmark::DoNotOptimize(cnf->getSize());
+        state.PauseTiming();
+        delete cnf;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations()*nbClauses);
+}
+
+static void bm_addClause(benchmark::State& state)
+{
+    addClauses(state, false);
+}
+
+static void bm_addClauses(benchmark::State& state)
+{
+    addClauses(state, true);
+}
+
+static void bm_isSymmetry(benchmark::State& state)
+{
+    const uint32_t nvars = state.range(0);
+    const uint32_t cyc = state.range(1);
+    Config* conf = make_conf(nvars);
+    OnlCNF* cnf = make_cnf(conf, nvars, cyc);
+    auto p = make_perm(conf, nvars, cyc);
+    // the first call fills the clause database
+    bool ok = cnf->isSymmetry(*p);
+    if (!ok) state.SkipWithError("synthetic permutation is not a symmetry");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cnf->isSymmetry(*p));
+    }
+    state.SetItemsProcessed(state.iterations()*cnf->getSize());
+    delete cnf;
+}
+
+///Matrix with rows of `cols` variables; the number of rows is nvars/cols.
+static shared_ptr<Matrix> make_matrix(Config* conf, uint32_t nvars, uint32_t cols)
+{
+    auto m = make_shared<Matrix>(conf);
+    for (uint32_t r = 0; r + cols <= nvars; r += cols) {
+        vector<BLit>* row = new vector<BLit>();
+        for (uint32_t c = 0; c < cols; c++) {
+            row->push_back(BLit(r + c, false));
+            row->push_back(BLit(r + c, true));
+        }
+        m->add(row);
+    }
+    return m;
+}
+
+static void bm_testMembership(benchmark::State& state)
+{
+    // here the second argument is the number of columns
+    const uint32_t nvars = state.range(0);
+    const uint32_t cols = state.range(1);
+    Config* conf = make_conf(nvars);
+    auto m = make_matrix(conf, nvars, cols);
+
+    // a cyclic shift of all rows, which is in the group of the matrix
+    vector<std::pair<BLit, BLit> > tuples;
+    const uint32_t rows = m->nbRows();
+    for (uint32_t r = 0; r < rows; r++) {
+        for (uint32_t c = 0; c < m->nbColumns(); c++) {
+            tuples.push_back({m->getLit(r, c), m->getLit((r+1) % rows, c)});
+        }
+    }
+    auto p = make_shared<Permutation>(tuples, conf);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m->testMembership(p)->isIdentity());
+    }
+    state.SetItemsProcessed(state.iterations()*p->supportSize());
+}
+
+static void bm_getOrbits2(benchmark::State& state)
+{
+    // several generators with overlapping supports, shifted by half a cycle
+    const uint32_t nvars = state.range(0);
+    const uint32_t cyc = state.range(1);
+    Config* conf = make_conf(nvars + cyc);
+    vector<shared_ptr<Permutation> > gens;
+    gens.push_back(make_perm(conf, nvars, cyc));
+    gens.push_back(make_perm(conf, nvars, cyc, cyc/2));
+    gens.push_back(make_perm(conf, nvars, 2));
+    for (auto _ : state) {
+        vector<shared_ptr<vector<BLit> > > orbits;
+        AlgebraicAlgos::getOrbits2(gens, orbits);
+        benchmark::DoNotOptimize(orbits.size());
+    }
+    state.SetItemsProcessed(state.iterations()*nvars*2);
+}
+
+static void addSym(benchmark::State& state, bool shatter)
+{
+    const uint32_t nvars = state.range(0);
+    Config* conf = make_conf(nvars);
+    conf->symBreakingFormLength = nvars;
+    conf->useShatterTranslation = shatter;
+    OnlCNF cnf(conf);
+    auto p = make_perm(conf, nvars, state.range(1));
+    vector<BLit> order;
+    for (uint32_t i = 0; i < nvars; i++) order.push_back(BLit(i, false));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Breaker* brkr = new Breaker(&cnf, conf);
+        state.ResumeTiming();
+        brkr->addSym(p, order, true);
+        benchmark::DoNotOptimize(brkr->getAddedNbClauses());
+        state.PauseTiming();
+        delete brkr;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations()*nvars);
+}
+
+static void bm_addBreakID(benchmark::State& state)
+{
+    addSym(state, false);
+}
+
+static void bm_addShatter(benchmark::State& state)
+{
+    addSym(state, true);
+}
+
+static void perm_args(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"vars", "cyc"});
+    for (int64_t vars : {1<<8, 1<<12, 1<<16}) {
+        for (int64_t cyc : {2, 3, 12, 64}) {
+            b->Args({vars, cyc});
+        }
+    }
+}
+
+static void matrix_args(benchmark::internal::Benchmark* b)
+{
+    // membership testing is superlinear in the number of rows
+    b->ArgNames({"vars", "cols"});
+    for (int64_t vars : {1<<8, 1<<10, 1<<12}) {
+        for (int64_t cols : {4, 32}) {
+            b->Args({vars, cols});
+        }
+    }
+}
+
+BENCHMARK(bm_getImage)->Apply(perm_args);
+BENCHMARK(bm_getCycleReprs)->Apply(perm_args);
+BENCHMARK(bm_addPrimeSplitToVector)->Apply(perm_args);
+BENCHMARK(bm_addClause)->Apply(perm_args);
+BENCHMARK(bm_addClauses)->Apply(perm_args);
+BENCHMARK(bm_isSymmetry)->Apply(perm_args);
+BENCHMARK(bm_testMembership)->Apply(matrix_args);
+BENCHMARK(bm_getOrbits2)->Apply(perm_args);
+BENCHMARK(bm_addBreakID)->Apply(perm_args);
+BENCHMARK(bm_addShatter)->Apply(perm_args);
+
+BENCHMARK_MAIN();
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "breakid.hpp"
 #include "GitSHA1.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <iterator>
@@ -51,6 +52,7 @@ struct BID::PrivateData
     vector<Group*> subgroups;
     uint32_t totalNbMatrices = 0;
     uint32_t totalNbRowSwaps = 0;
+    uint32_t totalNbRedundantGens = 0;
 
     OnlCNF* theory = NULL;
     Breaker* brkr = NULL;
@@ -105,6 +107,22 @@ void BreakID::set_symBreakingFormLength(int val)
     dat->conf->symBreakingFormLength = val;
 }
 
+void BreakID::set_removeRedundantGens(bool val)
+{
+    dat->conf->removeRedundantGens = val;
+}
+
+void BreakID::set_breakingBudget(int64_t clauses, int64_t aux_vars)
+{
+    dat->conf->breakingClauseBudget = clauses;
+    dat->conf->breakingAuxBudget = aux_vars;
+}
+
+void BreakID::set_var_priority(const vector<double>& prio)
+{
+    dat->conf->varPriority = prio;
+}
+
 void BreakID::set_verbosity(uint32_t val)
 {
     dat->conf->verbosity = val;
@@ -115,6 +133,53 @@ void BreakID::set_steps_lim(int64_t val)
     dat->conf->steps_lim = val;
 }
 
+void BreakID::set_progress_callback(ProgressCallback cb, uint32_t period)
+{
+    assert(period > 0);
+    dat->conf->progress_cb = cb;
+    dat->conf->progress_period = period;
+}
+
+void BreakID::set_splitHeuristic(SplitHeuristic val)
+{
+    assert((uint32_t)val < nb_split_heuristics);
+    dat->conf->splitHeuristic = val;
+}
+
+void BreakID::set_usePortfolio(bool val)
+{
+    dat->conf->usePortfolio = val;
+    dat->conf->portfolioDone = false;
+}
+
+void BreakID::set_autoSplitHeuristic(bool val)
+{
+    dat->conf->autoSplitHeuristic = val;
+    dat->conf->autoSplitDone = false;
+}
+
+void BreakID::set_searchThreads(uint32_t val)
+{
+    assert(val > 0);
+    dat->conf->searchThreads = val;
+}
+
+void BreakID::set_randomizedSearch(uint32_t nof_fails)
+{
+    if (nof_fails == 0) {
+        dat->conf->detector = Detector::bliss;
+        return;
+    }
+    dat->conf->detector = Detector::random;
+    dat->conf->randomizedFails = nof_fails;
+}
+
+void BreakID::set_detector(Detector val)
+{
+    assert((uint32_t)val < nb_detectors);
+    dat->conf->detector = val;
+}
+
 int64_t BreakID::get_steps_remain() const
 {
     return dat->conf->remain_steps_lim;
@@ -132,6 +197,11 @@ void BreakID::add_clause(BID::BLit* start, size_t num)
     dat->theory->add_clause(start, num);
 }
 
+void BreakID::add_clauses(const BID::BLit* lits, const uint32_t* offsets, size_t num)
+{
+    dat->theory->add_clauses(lits, offsets, num);
+}
+
 void BreakID::end_dynamic_cnf()
 {
     dat->theory->end_dynamic_cnf();
@@ -152,16 +222,108 @@ uint64_t BreakID::get_num_subgroups() const
     return dat->subgroups.size();
 }
 
+uint32_t BreakID::get_num_matrices() const
+{
+    return dat->totalNbMatrices;
+}
+
+uint32_t BreakID::get_num_row_swaps() const
+{
+    return dat->totalNbRowSwaps;
+}
+
+uint32_t BreakID::get_num_redundant_gens() const
+{
+    return dat->totalNbRedundantGens;
+}
+
+long double BreakID::get_group_size_approx() const
+{
+    return dat->theory->groupSize;
+}
+
+SubgroupStats BreakID::get_subgroup_stats(uint64_t idx) const
+{
+    SubgroupStats stats;
+    dat->subgroups.at(idx)->getStats(stats);
+    return stats;
+}
+
+SplitHeuristic BreakID::get_splitHeuristic() const
+{
+    return dat->conf->splitHeuristic;
+}
+
+Detector BreakID::get_detector() const
+{
+    return dat->conf->detector;
+}
+
+vector<vector<BID::BLit>> BreakID::get_approx_orbits()
+{
+    vector<vector<BID::BLit>> orbits;
+    dat->theory->graph->getApproxOrbits(orbits);
+    return orbits;
+}
+
 void BreakID::print_subgroups(std::ostream& out, const char* prefix) {
     for (auto& grp : dat->subgroups) {
+        SubgroupStats stats;
+        grp->getStats(stats);
         out
         << "group size: " << grp->getSize()
-        << " support: " << grp->getSupportSize() << endl;
+        << " support: " << grp->getSupportSize()
+        << " order: " << (stats.order.empty() ? "?" : stats.order)
+        << " log10(order): " << stats.log10_order
+        << " orbits: " << stats.nb_orbits
+        << " max orbit: " << stats.max_orbit
+        << " max cycle: " << stats.max_cycle << endl;
+        out << prefix << "orbit sizes:";
+        for (const auto& s : stats.orbit_sizes) {
+            out << " " << s.second << "x" << s.first;
+        }
+        out << endl;
 
         grp->print(out, prefix);
     }
 }
 
+///Spends the breaking budget greedily: first on the binary clauses of the
+///subgroups with the largest orbits, then on the lex-leader chains of all
+///generators, the most effective first, see BreakingCandidate
+static void addBreakingClausesWithinBudget(
+    const vector<Group*>& subgroups, Breaker& brkr, Config* conf)
+{
+    vector<std::pair<uint32_t, Group*> > ranked;
+    for (auto grp : subgroups) {
+        ranked.push_back({grp->getMaxOrbitSize(), grp});
+    }
+    std::stable_sort(ranked.begin(), ranked.end(),
+        [](const std::pair<uint32_t, Group*>& a, const std::pair<uint32_t, Group*>& b) {
+            if (a.first != b.first) return a.first > b.first;
+            return a.second->getSupportSize() < b.second->getSupportSize();
+        });
+
+    vector<vector<BLit> > orders(ranked.size());
+    vector<BreakingCandidate> candidates;
+    for (uint32_t i = 0; i < ranked.size(); ++i) {
+        ranked[i].second->getOrderAndAddBinaryClausesTo(brkr, orders[i]);
+        ranked[i].second->addBreakingCandidatesTo(orders[i], i, candidates);
+    }
+    std::stable_sort(candidates.begin(), candidates.end());
+
+    if (conf->verbosity > 1) {
+        cout << "c Breaking " << candidates.size() << " generators within budget" << endl;
+    }
+    for (auto& cand : candidates) {
+        if (cand.rowSwap) {
+            brkr.addLexLeq(cand.rowChain);
+        } else {
+            brkr.addSym(cand.perm, *cand.order, true);
+        }
+    }
+}
+
 void BreakID::break_symm()
 {
     dat->brkr = new Breaker(dat->theory, dat->conf);
@@ -183,9 +345,20 @@ void BreakID::break_symm()
             dat->totalNbRowSwaps += grp->getNbRowSwaps();
         }
 
-        //Symmetry
-        if (dat->conf->symBreakingFormLength > -1) {
-            if (dat->conf->verbosity > 0) cout << "c Constructing symmetry breaking formula..." << endl;
+        if (dat->conf->removeRedundantGens) {
+            dat->totalNbRedundantGens += grp->removeRedundantGenerators();
+        }
+    }
+
+    //Symmetry
+    if (dat->conf->symBreakingFormLength <= -1) {
+        return;
+    }
+    if (dat->conf->verbosity > 0) cout << "c Constructing symmetry breaking formula..." << endl;
+    if (dat->conf->breakingClauseBudget > -1 || dat->conf->breakingAuxBudget > -1) {
+        addBreakingClausesWithinBudget(dat->subgroups, *dat->brkr, dat->conf);
+    } else {
+        for (auto& grp : dat->subgroups) {
             grp->addBreakingClausesTo(*dat->brkr);
         }
     }
@@ -195,6 +368,7 @@ void BreakID::print_symm_break_stats(const char* prefix)
 {
     cout << prefix << "matrices detected: " << dat->totalNbMatrices << endl;
     cout << prefix << "row swaps detected: " << dat->totalNbRowSwaps << endl;
+    cout << prefix << "redundant generators removed: " << dat->totalNbRedundantGens << endl;
     cout << prefix << "extra binary symmetry breaking clauses added: " << dat->brkr->getNbBinClauses() << "\n";
     cout << prefix << "regular symmetry breaking clauses added: " << dat->brkr->getNbRegClauses() << "\n";
     cout << prefix << "row interchangeability breaking clauses added: " << dat->brkr->getNbRowClauses() << "\n";
@@ -236,6 +410,32 @@ void BreakID::get_perms(vector<std::unordered_map<BLit, BLit> >* out)
     }
 }
 
+void BreakID::visit_brk_cls(const LitsVisitor& visitor)
+{
+    dat->brkr->visitClauses(visitor);
+}
+
+void BreakID::visit_perms(const PermVisitor& visitor)
+{
+    for (auto grp : dat->subgroups) {
+        grp->visitPermutations(visitor);
+    }
+}
+
+void BreakID::visit_matrices(const RowVisitor& visitor)
+{
+    uint32_t idx = 0;
+    for (auto grp : dat->subgroups) {
+        for (uint32_t i = 0; i < grp->getNbMatrices(); ++i, ++idx) {
+            shared_ptr<Matrix> m = grp->getMatrix(i);
+            for (uint32_t r = 0; r < m->nbRows(); ++r) {
+                const vector<BLit>* row = m->getRow(r);
+                visitor(idx, row->data(), row->size());
+            }
+        }
+    }
+}
+
 std::string BreakID::get_version_sha1()
 {
     return BID::get_version_sha1();
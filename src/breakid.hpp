@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include <unordered_map>
 #include <iostream>
 #include <cstdint>
+#include <functional>
 
 namespace BID {
 
@@ -80,6 +81,64 @@ DLL_PUBLIC inline std::ostream& operator<<(std::ostream& os, const BLit lit)
     return os;
 }
 
+///Snapshot of the automorphism search, handed to the progress callback
+struct SearchProgress {
+    uint64_t nodes; ///<search tree nodes explored so far
+    uint64_t generators; ///<generators found so far
+    int64_t steps_remain; ///<remaining step budget, see set_steps_lim()
+    double elapsed_time; ///<time spent in this search, in seconds
+};
+
+///Return false to stop the search early
+typedef std::function<bool(const SearchProgress&)> ProgressCallback;
+
+///Receives a list of literals, e.g. a clause, without a copy being made
+typedef std::function<void(const BLit* lits, size_t num)> LitsVisitor;
+
+///Receives a generator as num literals and their images
+typedef std::function<void(const BLit* from, const BLit* to, size_t num)> PermVisitor;
+
+///Receives a row of matrix number `matrix`, the matrices being numbered
+///over all subgroups and their rows visited in order
+typedef std::function<void(uint32_t matrix, const BLit* row, size_t num)> RowVisitor;
+
+///Splitting heuristics of the automorphism search, in the order of
+///bliss::Graph::SplittingHeuristic: first/smallest/largest non-singleton
+///cell, optionally maximally non-trivially connected (m)
+enum class SplitHeuristic : uint32_t {f = 0, fs, fl, fm, fsm, flm};
+constexpr uint32_t nb_split_heuristics = 6;
+
+inline const char* to_string(SplitHeuristic h)
+{
+    static const char* names[] = {"f", "fs", "fl", "fm", "fsm", "flm"};
+    return names[(uint32_t)h];
+}
+
+///Symmetry detection engines, see set_detector()
+enum class Detector : uint32_t {bliss = 0, random, refine};
+constexpr uint32_t nb_detectors = 3;
+
+inline const char* to_string(Detector d)
+{
+    static const char* names[] = {"bliss", "random", "refine"};
+    return names[(uint32_t)d];
+}
+
+///Statistics of a subgroup, see get_subgroup_stats()
+struct SubgroupStats {
+    ///exact order in decimal, empty if it took too many steps to compute
+    std::string order;
+    ///log10 of the order, a lower bound if order is empty
+    double log10_order = 0;
+    ///orbits of the literals, all of them of at least two literals
+    uint32_t nb_orbits = 0;
+    uint32_t max_orbit = 0;
+    ///(size, number of orbits of that size), by increasing size
+    std::vector<std::pair<uint32_t, uint32_t> > orbit_sizes;
+    ///longest cycle of a generator, the matrix row swaps included
+    uint32_t max_cycle = 0;
+};
+
 struct BreakID {
     DLL_PUBLIC BreakID();
     DLL_PUBLIC ~BreakID();
@@ -92,12 +151,54 @@ struct BreakID {
     DLL_PUBLIC void set_useShatterTranslation(bool val);
     DLL_PUBLIC void set_useFullTranslation(bool val);
     DLL_PUBLIC void set_symBreakingFormLength(int val);
+    ///Drop the generators that are products of the others before
+    ///breaking, fewer clauses for the same group but a weaker formula
+    DLL_PUBLIC void set_removeRedundantGens(bool val);
+    ///Upper limits on the symmetry breaking clauses and auxiliary variables
+    ///added in total, -1 for none. Within a limit, the subgroups and
+    ///generators expected to break the most are broken first.
+    DLL_PUBLIC void set_breakingBudget(int64_t clauses, int64_t aux_vars);
+    ///Priority of each variable, by index, e.g. the initial activities of
+    ///the solver. The lex-leader order puts higher priorities first, as far
+    ///as the stabilizer chain of each subgroup allows, so that the breaking
+    ///clauses agree with the first decisions of the solver. Matrix
+    ///variables keep their row-wise order. Missing variables get 0, an
+    ///empty vector restores the default order.
+    DLL_PUBLIC void set_var_priority(const std::vector<double>& prio);
     DLL_PUBLIC void set_verbosity(uint32_t val);
     DLL_PUBLIC void set_steps_lim(int64_t val);
+    ///Called every `period` search tree nodes during symmetry detection
+    DLL_PUBLIC void set_progress_callback(ProgressCallback cb, uint32_t period = 10000);
+    DLL_PUBLIC void set_splitHeuristic(SplitHeuristic val);
+    ///Race all splitting heuristics on separate threads, the first one
+    ///to finish wins and is used for the rest of the run
+    DLL_PUBLIC void set_usePortfolio(bool val);
+    ///Choose the splitting heuristic from features of the graph, instead
+    ///of the one given to set_splitHeuristic()
+    DLL_PUBLIC void set_autoSplitHeuristic(bool val);
+    ///Number of threads of each symmetry search, 1 for the sequential search.
+    ///Only the first level of the search tree is parallel, see
+    ///bliss::Graph::find_automorphisms_parallel()
+    DLL_PUBLIC void set_searchThreads(uint32_t val);
+    ///Find the generators by random walks in the search tree instead of the
+    ///exhaustive search, stopping after `nof_fails` consecutive random
+    ///automorphisms already in the group found. Faster on large graphs, but
+    ///may miss generators with a probability that shrinks with `nof_fails`.
+    ///0 switches back to the exhaustive search.
+    DLL_PUBLIC void set_randomizedSearch(uint32_t nof_fails);
+    ///Engine of the symmetry detection: the exhaustive search of bliss
+    ///(default), the randomized one of set_randomizedSearch(), or refine,
+    ///which runs no search and finds no generators, for a quick
+    ///get_approx_orbits()
+    DLL_PUBLIC void set_detector(Detector val);
 
     //Dynamic CNF
     DLL_PUBLIC void start_dynamic_cnf(uint32_t nVars);
     DLL_PUBLIC void add_clause(BID::BLit* start, size_t num);
+    ///Adds num clauses at once, clause i being lits[offsets[i]] up to
+    ///lits[offsets[i+1]-1], so offsets has num+1 entries. Faster than
+    ///add_clause() on large CNFs, as memory is reserved once.
+    DLL_PUBLIC void add_clauses(const BID::BLit* lits, const uint32_t* offsets, size_t num);
     DLL_PUBLIC void end_dynamic_cnf();
 
     //Main functions
@@ -116,9 +217,34 @@ struct BreakID {
     DLL_PUBLIC uint32_t get_num_aux_vars();
     DLL_PUBLIC int64_t get_steps_remain() const;
     DLL_PUBLIC uint64_t get_num_subgroups() const;
+    DLL_PUBLIC uint32_t get_num_matrices() const;
+    DLL_PUBLIC uint32_t get_num_row_swaps() const;
+    DLL_PUBLIC uint32_t get_num_redundant_gens() const;
+    ///Order of the whole symmetry group as counted by the symmetry search,
+    ///approximate, 0 if the detector does not count it
+    DLL_PUBLIC long double get_group_size_approx() const;
+    ///Order, orbits and longest cycle of the subgroup idx <
+    ///get_num_subgroups(), including the matrices once break_symm() ran
+    DLL_PUBLIC SubgroupStats get_subgroup_stats(uint64_t idx) const;
+    ///The heuristic in use, after a portfolio run the one that won
+    DLL_PUBLIC SplitHeuristic get_splitHeuristic() const;
+    DLL_PUBLIC Detector get_detector() const;
+    ///Cells of the equitable partition of the literals, without search,
+    ///available after end_dynamic_cnf(). Each orbit of the symmetry group
+    ///is inside one of them, so literals outside all of them are fixed by
+    ///every symmetry; if there is none, the CNF has no symmetry.
+    ///Only cells of at least two literals are returned.
+    DLL_PUBLIC std::vector<std::vector<BID::BLit>> get_approx_orbits();
     DLL_PUBLIC std::vector<std::vector<BID::BLit>> get_brk_cls();
     DLL_PUBLIC void get_perms(std::vector<std::unordered_map<BLit, BLit> >* out);
 
+    ///Same as get_brk_cls(), get_perms() and the matrices printed by
+    ///print_perms_and_matrices(), without copying them. Repeated calls
+    ///visit in the same order as long as the breaking formula is unchanged.
+    DLL_PUBLIC void visit_brk_cls(const LitsVisitor& visitor);
+    DLL_PUBLIC void visit_perms(const PermVisitor& visitor);
+    DLL_PUBLIC void visit_matrices(const RowVisitor& visitor);
+
 private:
     BID::PrivateData* dat = NULL;
 };
@@ -44,6 +44,89 @@ Dest unwrap(const std::vector<T>& vec)
     return Dest {toc(vec.data()), vec.size()};
 }
 
+//Flattens lists of literals as lit1 lit2 UINT_MAX lit1 UINT_MAX ...
+static unsigned* flatten_lits(const std::vector<std::vector<BLit>>& lists, int* num)
+{
+    *num = lists.size();
+    size_t total_sz = 0;
+    for (auto const& l: lists) {
+        total_sz += l.size()+1;
+    }
+    unsigned* ptr = (unsigned*) malloc(total_sz * sizeof(unsigned));
+    unsigned* at = ptr;
+    for (auto const& l: lists) {
+         for(auto const& lit: l) {
+             *at = lit.toInt();
+             at++;
+         }
+         *at = UINT_MAX;
+         at++;
+    }
+    return ptr;
+}
+
+static size_t brk_cls_size(BreakID* bid)
+{
+    size_t total_sz = 0;
+    bid->visit_brk_cls([&](const BLit*, size_t num) {
+        total_sz += num+1;
+    });
+    return total_sz;
+}
+
+static int brk_cls_into(BreakID* bid, unsigned* buf)
+{
+    int num = 0;
+    bid->visit_brk_cls([&](const BLit* lits, size_t sz) {
+        for (size_t i = 0; i < sz; i++) {
+            *buf++ = lits[i].toInt();
+        }
+        *buf++ = UINT_MAX;
+        num++;
+    });
+    return num;
+}
+
+static size_t generators_size(BreakID* bid)
+{
+    size_t total_sz = 0;
+    bid->visit_perms([&](const BLit*, const BLit*, size_t num) {
+        total_sz += 2*num+1;
+    });
+    return total_sz;
+}
+
+///Writes the matrices to buf, unless it is NULL, and returns the number of
+///unsigneds they take, so that the size is that of the copy
+static size_t matrices_into(BreakID* bid, unsigned* buf, int* num)
+{
+    size_t total_sz = 0;
+    auto put = [&](unsigned x) {
+        if (buf) buf[total_sz] = x;
+        total_sz++;
+    };
+    int nb = 0;
+    uint32_t last = 0;
+    bid->visit_matrices([&](uint32_t matrix, const BLit* row, size_t sz) {
+        if (nb == 0 || matrix != last) {
+            if (nb > 0) {
+                put(UINT_MAX);
+            }
+            nb++;
+            last = matrix;
+        }
+        for (size_t i = 0; i < sz; i++) {
+            put(row[i].toInt());
+        }
+        put(UINT_MAX);
+    });
+    if (nb > 0) {
+        put(UINT_MAX);
+    }
+    if (num) *num = nb;
+    return total_sz;
+}
+
 #define NOEXCEPT_START noexcept { try {
 #define NOEXCEPT_END } catch(...) { \
     std::cerr << "ERROR: exception thrown past FFI boundary" << std::endl;\
@@ -83,6 +166,18 @@ extern "C"
             bid->set_symBreakingFormLength(val);
     } NOEXCEPT_END
 
+    DLL_PUBLIC void breakid_set_removeRedundantGens(BreakID* bid, bool val) NOEXCEPT_START {
+            bid->set_removeRedundantGens(val);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC void breakid_set_breakingBudget(BreakID* bid, int64_t clauses, int64_t aux_vars) NOEXCEPT_START {
+            bid->set_breakingBudget(clauses, aux_vars);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC void breakid_set_var_priority(BreakID* bid, const double* prio, size_t num) NOEXCEPT_START {
+            bid->set_var_priority(std::vector<double>(prio, prio + num));
+    } NOEXCEPT_END
+
     DLL_PUBLIC void breakid_set_verbosity(BreakID* bid, uint32_t val) NOEXCEPT_START {
             bid->set_verbosity(val);
     } NOEXCEPT_END
@@ -91,6 +186,38 @@ extern "C"
             bid->set_steps_lim(val);
     } NOEXCEPT_END
 
+    DLL_PUBLIC void breakid_set_splitHeuristic(BreakID* bid, uint32_t val) NOEXCEPT_START {
+            if (val >= BID::nb_split_heuristics) {
+                std::cerr << "ERROR: unknown splitting heuristic " << val << std::endl;
+                std::exit(-1);
+            }
+            bid->set_splitHeuristic((BID::SplitHeuristic)val);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC void breakid_set_usePortfolio(BreakID* bid, bool val) NOEXCEPT_START {
+            bid->set_usePortfolio(val);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC void breakid_set_autoSplitHeuristic(BreakID* bid, bool val) NOEXCEPT_START {
+            bid->set_autoSplitHeuristic(val);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC void breakid_set_searchThreads(BreakID* bid, uint32_t val) NOEXCEPT_START {
+            bid->set_searchThreads(val);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC void breakid_set_randomizedSearch(BreakID* bid, uint32_t nof_fails) NOEXCEPT_START {
+            bid->set_randomizedSearch(nof_fails);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC void breakid_set_detector(BreakID* bid, uint32_t val) NOEXCEPT_START {
+            if (val >= BID::nb_detectors) {
+                std::cerr << "ERROR: unknown detector " << val << std::endl;
+                std::exit(-1);
+            }
+            bid->set_detector((BID::Detector)val);
+    } NOEXCEPT_END
+
 
     //Print info
     DLL_PUBLIC void breakid_print_subgroups(BreakID* bid) NOEXCEPT_START {
@@ -131,6 +258,46 @@ extern "C"
         return bid->get_num_subgroups();
     } NOEXCEPT_END
 
+    DLL_PUBLIC uint32_t breakid_get_num_matrices(BreakID* bid) NOEXCEPT_START {
+        return bid->get_num_matrices();
+    } NOEXCEPT_END
+
+    DLL_PUBLIC uint32_t breakid_get_num_row_swaps(BreakID* bid) NOEXCEPT_START {
+        return bid->get_num_row_swaps();
+    } NOEXCEPT_END
+
+    DLL_PUBLIC uint32_t breakid_get_num_redundant_gens(BreakID* bid) NOEXCEPT_START {
+        return bid->get_num_redundant_gens();
+    } NOEXCEPT_END
+
+    DLL_PUBLIC long double breakid_get_group_size_approx(BreakID* bid) NOEXCEPT_START {
+        return bid->get_group_size_approx();
+    } NOEXCEPT_END
+
+    DLL_PUBLIC double breakid_get_subgroup_log10_order(BreakID* bid, uint64_t idx) NOEXCEPT_START {
+        return bid->get_subgroup_stats(idx).log10_order;
+    } NOEXCEPT_END
+
+    DLL_PUBLIC uint32_t breakid_get_subgroup_num_orbits(BreakID* bid, uint64_t idx) NOEXCEPT_START {
+        return bid->get_subgroup_stats(idx).nb_orbits;
+    } NOEXCEPT_END
+
+    DLL_PUBLIC uint32_t breakid_get_subgroup_max_orbit(BreakID* bid, uint64_t idx) NOEXCEPT_START {
+        return bid->get_subgroup_stats(idx).max_orbit;
+    } NOEXCEPT_END
+
+    DLL_PUBLIC uint32_t breakid_get_subgroup_max_cycle(BreakID* bid, uint64_t idx) NOEXCEPT_START {
+        return bid->get_subgroup_stats(idx).max_cycle;
+    } NOEXCEPT_END
+
+    DLL_PUBLIC uint32_t breakid_get_splitHeuristic(BreakID* bid) NOEXCEPT_START {
+        return (uint32_t)bid->get_splitHeuristic();
+    } NOEXCEPT_END
+
+    DLL_PUBLIC uint32_t breakid_get_detector(BreakID* bid) NOEXCEPT_START {
+        return (uint32_t)bid->get_detector();
+    } NOEXCEPT_END
+
     //Dynamic CNF
     DLL_PUBLIC void breakid_start_dynamic_cnf(BreakID* bid, uint32_t nVars) NOEXCEPT_START {
         bid->start_dynamic_cnf(nVars);
@@ -140,6 +307,10 @@ extern "C"
         bid->add_clause((BID::BLit*)start, num);
     } NOEXCEPT_END
 
+    DLL_PUBLIC void breakid_add_clauses(BreakID* bid, const int* lits, const uint32_t* offsets, size_t num) NOEXCEPT_START {
+        bid->add_clauses((const BID::BLit*)lits, offsets, num);
+    } NOEXCEPT_END
+
     DLL_PUBLIC void breakid_end_dynamic_cnf(BreakID* bid) NOEXCEPT_START {
         bid->end_dynamic_cnf();
     } NOEXCEPT_END
@@ -154,22 +325,56 @@ extern "C"
     } NOEXCEPT_END
 
     DLL_PUBLIC unsigned* breakid_get_brk_cls(BreakID* bid, int* num) NOEXCEPT_START {
-        auto brk = bid->get_brk_cls();
-        *num = brk.size();
-        size_t total_sz = 0;
-        for (auto cl: brk) {
-            total_sz += cl.size()+1;
+        unsigned* ptr = (unsigned*) malloc(brk_cls_size(bid) * sizeof(unsigned));
+        *num = brk_cls_into(bid, ptr);
+        return ptr;
+    } NOEXCEPT_END
+
+    DLL_PUBLIC size_t breakid_get_brk_cls_size(BreakID* bid) NOEXCEPT_START {
+        return brk_cls_size(bid);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC int breakid_get_brk_cls_into(BreakID* bid, unsigned* buf, size_t cap) NOEXCEPT_START {
+        if (brk_cls_size(bid) > cap) {
+            return -1;
         }
-        unsigned* cls_ptr = (unsigned*) malloc(total_sz * sizeof(unsigned));
-        unsigned* at = cls_ptr;
-        for (auto const& cl: brk) {
-             for(auto const& lit: cl) {
-                 *at = lit.toInt();
-                 at++;
-             }
-             *at = UINT_MAX;
-             at++;
+        return brk_cls_into(bid, buf);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC size_t breakid_get_generators_size(BreakID* bid) NOEXCEPT_START {
+        return generators_size(bid);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC int breakid_get_generators_into(BreakID* bid, unsigned* buf, size_t cap) NOEXCEPT_START {
+        if (generators_size(bid) > cap) {
+            return -1;
         }
-        return cls_ptr;
+        int num = 0;
+        bid->visit_perms([&](const BLit* from, const BLit* to, size_t sz) {
+            for (size_t i = 0; i < sz; i++) {
+                *buf++ = from[i].toInt();
+                *buf++ = to[i].toInt();
+            }
+            *buf++ = UINT_MAX;
+            num++;
+        });
+        return num;
+    } NOEXCEPT_END
+
+    DLL_PUBLIC size_t breakid_get_matrices_size(BreakID* bid) NOEXCEPT_START {
+        return matrices_into(bid, NULL, NULL);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC int breakid_get_matrices_into(BreakID* bid, unsigned* buf, size_t cap) NOEXCEPT_START {
+        if (matrices_into(bid, NULL, NULL) > cap) {
+            return -1;
+        }
+        int num = 0;
+        matrices_into(bid, buf, &num);
+        return num;
+    } NOEXCEPT_END
+
+    DLL_PUBLIC unsigned* breakid_get_approx_orbits(BreakID* bid, int* num) NOEXCEPT_START {
+        return flatten_lits(bid->get_approx_orbits(), num);
     } NOEXCEPT_END
 }
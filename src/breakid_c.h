@@ -59,12 +59,24 @@ BID_DLL_PUBLIC void breakid_set_useBinaryClauses(BreakID* bid, bool val) NOEXCEP
 BID_DLL_PUBLIC void breakid_set_useShatterTranslation(BreakID* bid, bool val) NOEXCEPT;
 BID_DLL_PUBLIC void breakid_set_useFullTranslation(BreakID* bid, bool val) NOEXCEPT;
 BID_DLL_PUBLIC void breakid_set_symBreakingFormLength(BreakID* bid, int val) NOEXCEPT;
+BID_DLL_PUBLIC void breakid_set_removeRedundantGens(BreakID* bid, bool val) NOEXCEPT;
+BID_DLL_PUBLIC void breakid_set_breakingBudget(BreakID* bid, int64_t clauses, int64_t aux_vars) NOEXCEPT;
+BID_DLL_PUBLIC void breakid_set_var_priority(BreakID* bid, const double* prio, size_t num) NOEXCEPT;
 BID_DLL_PUBLIC void breakid_set_verbosity(BreakID* bid, uint32_t val) NOEXCEPT;
 BID_DLL_PUBLIC void breakid_set_steps_lim(BreakID* bid, int64_t val) NOEXCEPT;
+// 0..5 for the splitting heuristics f, fs, fl, fm, fsm, flm
+BID_DLL_PUBLIC void breakid_set_splitHeuristic(BreakID* bid, uint32_t val) NOEXCEPT;
+BID_DLL_PUBLIC void breakid_set_usePortfolio(BreakID* bid, bool val) NOEXCEPT;
+BID_DLL_PUBLIC void breakid_set_autoSplitHeuristic(BreakID* bid, bool val) NOEXCEPT;
+BID_DLL_PUBLIC void breakid_set_searchThreads(BreakID* bid, uint32_t val) NOEXCEPT;
+BID_DLL_PUBLIC void breakid_set_randomizedSearch(BreakID* bid, uint32_t nof_fails) NOEXCEPT;
+// 0: bliss, 1: random, 2: refine, in the order of BID::Detector
+BID_DLL_PUBLIC void breakid_set_detector(BreakID* bid, uint32_t val) NOEXCEPT;
 
 //Dynamic CNF
 BID_DLL_PUBLIC void breakid_start_dynamic_cnf(BreakID* bid, uint32_t nVars) NOEXCEPT;
 BID_DLL_PUBLIC void breakid_add_clause(BreakID* bid, int* start, size_t num) NOEXCEPT;
+BID_DLL_PUBLIC void breakid_add_clauses(BreakID* bid, const int* lits, const uint32_t* offsets, size_t num) NOEXCEPT;
 BID_DLL_PUBLIC void breakid_end_dynamic_cnf(BreakID* bid) NOEXCEPT;
 
 //Main functions
@@ -83,12 +95,45 @@ BID_DLL_PUBLIC uint32_t breakid_get_num_break_cls(BreakID* bid) NOEXCEPT;
 BID_DLL_PUBLIC uint32_t breakid_get_num_aux_vars(BreakID* bid) NOEXCEPT;
 BID_DLL_PUBLIC int64_t  breakid_get_steps_remain(BreakID* bid) NOEXCEPT;
 BID_DLL_PUBLIC uint64_t breakid_get_num_subgroups(BreakID* bid) NOEXCEPT;
+BID_DLL_PUBLIC uint32_t breakid_get_num_matrices(BreakID* bid) NOEXCEPT;
+BID_DLL_PUBLIC uint32_t breakid_get_num_row_swaps(BreakID* bid) NOEXCEPT;
+BID_DLL_PUBLIC uint32_t breakid_get_num_redundant_gens(BreakID* bid) NOEXCEPT;
+BID_DLL_PUBLIC long double breakid_get_group_size_approx(BreakID* bid) NOEXCEPT;
+// Statistics of subgroup idx < breakid_get_num_subgroups(),
+// see BID::SubgroupStats
+BID_DLL_PUBLIC double breakid_get_subgroup_log10_order(BreakID* bid, uint64_t idx) NOEXCEPT;
+BID_DLL_PUBLIC uint32_t breakid_get_subgroup_num_orbits(BreakID* bid, uint64_t idx) NOEXCEPT;
+BID_DLL_PUBLIC uint32_t breakid_get_subgroup_max_orbit(BreakID* bid, uint64_t idx) NOEXCEPT;
+BID_DLL_PUBLIC uint32_t breakid_get_subgroup_max_cycle(BreakID* bid, uint64_t idx) NOEXCEPT;
+BID_DLL_PUBLIC uint32_t breakid_get_splitHeuristic(BreakID* bid) NOEXCEPT;
+BID_DLL_PUBLIC uint32_t breakid_get_detector(BreakID* bid) NOEXCEPT;
 
 // Returns the number of clauses in `num_ret` and returns an int* that
 // contains all clauses's literals with a 0 in between:
 // lit1 lit2 lit3 UINT_MAX lit1 lit2 UINT_MAX ... where 1st clause contains lit1, lit2, lit3
 BID_DLL_PUBLIC unsigned* breakid_get_brk_cls(BreakID* bid, int* num_ret) NOEXCEPT;
 
+// Same format as breakid_get_brk_cls(), with the approximate orbits of
+// BreakID::get_approx_orbits() instead of clauses
+BID_DLL_PUBLIC unsigned* breakid_get_approx_orbits(BreakID* bid, int* num_ret) NOEXCEPT;
+
+// Caller-owned buffer variants, for reusing preallocated buffers: the _size
+// function returns the number of unsigneds needed, the _into function fills
+// `buf` and returns the number of items, or -1 if `cap` is too small, in
+// which case `buf` is left untouched.
+//
+// Breaking clauses, same format as breakid_get_brk_cls()
+BID_DLL_PUBLIC size_t breakid_get_brk_cls_size(BreakID* bid) NOEXCEPT;
+BID_DLL_PUBLIC int breakid_get_brk_cls_into(BreakID* bid, unsigned* buf, size_t cap) NOEXCEPT;
+// Generators of BreakID::get_perms(), each one as the literals it moves
+// and their images, then UINT_MAX: lit1 img1 lit2 img2 UINT_MAX lit1 img1 ...
+BID_DLL_PUBLIC size_t breakid_get_generators_size(BreakID* bid) NOEXCEPT;
+BID_DLL_PUBLIC int breakid_get_generators_into(BreakID* bid, unsigned* buf, size_t cap) NOEXCEPT;
+// Matrices, each row followed by UINT_MAX and each matrix by another one:
+// r1l1 r1l2 UINT_MAX r2l1 r2l2 UINT_MAX UINT_MAX r1l1 ...
+BID_DLL_PUBLIC size_t breakid_get_matrices_size(BreakID* bid) NOEXCEPT;
+BID_DLL_PUBLIC int breakid_get_matrices_into(BreakID* bid, unsigned* buf, size_t cap) NOEXCEPT;
+
 
 #ifdef __cplusplus
 } // end extern c
@@ -0,0 +1,512 @@
+/******************************************
+Copyright (c) 2024 Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+// Generators for families of highly symmetric CNFs whose size can be dialed
+// precisely. Used by breakid-gen and breakid-bench, not part of the library.
+//
+// Every generator first announces the exact number of variables and clauses
+// to the sink, then streams the clauses, so nothing is buffered: the output
+// can go straight to BreakID::add_clause() or to a DIMACS file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "breakid.hpp"
+
+namespace BID {
+namespace gen {
+
+class ClauseSink {
+public:
+    virtual ~ClauseSink() {}
+    ///Called exactly once, before the first clause
+    virtual void header(uint32_t nVars, uint64_t nClauses) = 0;
+    virtual void clause(const std::vector<BLit>& cl) = 0;
+};
+
+///Writes DIMACS to a FILE, formatting the literals by hand as this is
+///the bottleneck for the largest instances
+class DimacsSink : public ClauseSink {
+public:
+    explicit DimacsSink(FILE* _out) : out(_out) {}
+    ~DimacsSink() { flush(); }
+
+    void header(uint32_t nVars, uint64_t nClauses) override
+    {
+        fprintf(out, "p cnf %u %llu\n", nVars, (unsigned long long)nClauses);
+    }
+
+    void clause(const std::vector<BLit>& cl) override
+    {
+        for (const BLit l: cl) {
+            if (l.sign()) buf.push_back('-');
+            write_uint(l.var()+1);
+            buf.push_back(' ');
+        }
+        buf.push_back('0');
+        buf.push_back('\n');
+        if (buf.size() > (1U << 20)) flush();
+    }
+
+    void flush()
+    {
+        fwrite(buf.data(), 1, buf.size(), out);
+        buf.clear();
+    }
+
+private:
+    void write_uint(uint32_t x)
+    {
+        char tmp[10];
+        int n = 0;
+        do {
+            tmp[n++] = '0' + x % 10;
+            x /= 10;
+        } while (x);
+        while (n) buf.push_back(tmp[--n]);
+    }
+
+    FILE* out;
+    std::string buf;
+};
+
+///Feeds the clauses into BreakID through the dynamic CNF interface. The
+///caller still has to call end_dynamic_cnf().
+class BreakIDSink : public ClauseSink {
+public:
+    explicit BreakIDSink(BreakID& _breakid) : breakid(_breakid) {}
+
+    void header(uint32_t nVars, uint64_t) override
+    {
+        breakid.start_dynamic_cnf(nVars);
+    }
+
+    void clause(const std::vector<BLit>& cl) override
+    {
+        breakid.add_clause(const_cast<BLit*>(cl.data()), cl.size());
+    }
+
+private:
+    BreakID& breakid;
+};
+
+///Keeps the clauses in memory
+class VectorSink : public ClauseSink {
+public:
+    void header(uint32_t _nVars, uint64_t nClauses) override
+    {
+        nVars = _nVars;
+        clauses.reserve(nClauses);
+    }
+
+    void clause(const std::vector<BLit>& cl) override
+    {
+        clauses.push_back(cl);
+    }
+
+    uint32_t nVars = 0;
+    std::vector<std::vector<BLit>> clauses;
+};
+
+///Invalid parameters of a family, reported by the caller
+inline void gen_error(const std::string& msg)
+{
+    throw std::invalid_argument(msg);
+}
+
+inline uint64_t choose2(uint64_t n) { return n*(n-1)/2; }
+
+inline void check_size(uint64_t nVars)
+{
+    if (nVars >= (1ULL << 31)) gen_error("too many variables requested");
+}
+
+///Pigeonhole principle, holes+1 pigeons into holes holes. Unsatisfiable.
+///Variable p(i,j) means pigeon i sits in hole j.
+inline void gen_php(uint32_t holes, ClauseSink& sink)
+{
+    if (holes < 1) gen_error("php needs at least 1 hole");
+    const uint64_t pigeons = (uint64_t)holes + 1;
+    check_size(pigeons*holes);
+    auto p = [&](uint32_t i, uint32_t j) { return (uint32_t)(i*holes + j); };
+
+    sink.header(pigeons*holes, pigeons + holes*choose2(pigeons));
+    std::vector<BLit> cl;
+    for (uint32_t i = 0; i < pigeons; i++) {
+        cl.clear();
+        for (uint32_t j = 0; j < holes; j++) cl.push_back(BLit(p(i, j), false));
+        sink.clause(cl);
+    }
+    for (uint32_t j = 0; j < holes; j++) {
+        for (uint32_t i = 0; i < pigeons; i++) {
+            for (uint32_t i2 = i+1; i2 < pigeons; i2++) {
+                cl = {BLit(p(i, j), true), BLit(p(i2, j), true)};
+                sink.clause(cl);
+            }
+        }
+    }
+}
+
+///Clique-coloring: a graph on n vertices has a k-clique and is c-colorable.
+///Unsatisfiable iff c < k. The vertices, the clique slots and the colors
+///are each fully interchangeable.
+inline void gen_clique_coloring(uint32_t n, uint32_t k, uint32_t c, ClauseSink& sink)
+{
+    if (n < 2 || k < 2 || c < 1) gen_error("clique coloring needs n >= 2, k >= 2, c >= 1");
+    const uint64_t nb_edges = choose2(n);
+    check_size(nb_edges + (uint64_t)k*n + (uint64_t)n*c);
+    // edges first, then clique slot vars q(i,u), then color vars r(u,l)
+    auto e = [&](uint32_t u, uint32_t v) {
+        if (u > v) std::swap(u, v);
+        return (uint32_t)((uint64_t)v*(v-1)/2 + u);
+    };
+    auto q = [&](uint32_t i, uint32_t u) { return (uint32_t)(nb_edges + (uint64_t)i*n + u); };
+    auto r = [&](uint32_t u, uint32_t l) {
+        return (uint32_t)(nb_edges + (uint64_t)k*n + (uint64_t)u*c + l);
+    };
+
+    const uint64_t nb_cls = k
+        + (uint64_t)n*choose2(k)
+        + choose2(k)*n*(n-1)
+        + n
+        + nb_edges*c;
+    sink.header(nb_edges + (uint64_t)k*n + (uint64_t)n*c, nb_cls);
+
+    std::vector<BLit> cl;
+    // every clique slot holds a vertex
+    for (uint32_t i = 0; i < k; i++) {
+        cl.clear();
+        for (uint32_t u = 0; u < n; u++) cl.push_back(BLit(q(i, u), false));
+        sink.clause(cl);
+    }
+    // no vertex fills two slots
+    for (uint32_t u = 0; u < n; u++) {
+        for (uint32_t i = 0; i < k; i++) {
+            for (uint32_t i2 = i+1; i2 < k; i2++) {
+                cl = {BLit(q(i, u), true), BLit(q(i2, u), true)};
+                sink.clause(cl);
+            }
+        }
+    }
+    // vertices in the clique are adjacent
+    for (uint32_t i = 0; i < k; i++) {
+        for (uint32_t i2 = i+1; i2 < k; i2++) {
+            for (uint32_t u = 0; u < n; u++) {
+                for (uint32_t v = 0; v < n; v++) {
+                    if (u == v) continue;
+                    cl = {BLit(q(i, u), true), BLit(q(i2, v), true), BLit(e(u, v), false)};
+                    sink.clause(cl);
+                }
+            }
+        }
+    }
+    // every vertex has a color
+    for (uint32_t u = 0; u < n; u++) {
+        cl.clear();
+        for (uint32_t l = 0; l < c; l++) cl.push_back(BLit(r(u, l), false));
+        sink.clause(cl);
+    }
+    // adjacent vertices differ in color
+    for (uint32_t v = 1; v < n; v++) {
+        for (uint32_t u = 0; u < v; u++) {
+            for (uint32_t l = 0; l < c; l++) {
+                cl = {BLit(e(u, v), true), BLit(r(u, l), true), BLit(r(v, l), true)};
+                sink.clause(cl);
+            }
+        }
+    }
+}
+
+///Urquhart-style Tseitin formula on a random deg-regular multigraph on n
+///vertices, with odd total charge. Unsatisfiable. Flipping the edge
+///variables along any cycle is a symmetry.
+inline void gen_urquhart(uint32_t n, uint32_t deg, uint64_t seed, ClauseSink& sink)
+{
+    if (deg < 2 || deg > 20) gen_error("urquhart needs 2 <= degree <= 20");
+    if (n < 2 || ((uint64_t)n*deg) % 2 != 0) {
+        gen_error("urquhart needs n >= 2 and n*degree even");
+    }
+    const uint64_t nb_edges = (uint64_t)n*deg/2;
+    check_size(nb_edges);
+
+    // configuration model, redrawn until there are no self-loops. The
+    // shuffle is written out so that the output is identical on all platforms.
+    std::mt19937_64 rnd(seed);
+    std::vector<uint32_t> stubs;
+    bool ok = false;
+    for (uint32_t tries = 0; tries < 1000 && !ok; tries++) {
+        stubs.clear();
+        for (uint32_t v = 0; v < n; v++) {
+            for (uint32_t d = 0; d < deg; d++) stubs.push_back(v);
+        }
+        for (size_t i = stubs.size()-1; i > 0; i--) {
+            std::swap(stubs[i], stubs[rnd() % (i+1)]);
+        }
+        ok = true;
+        for (size_t i = 0; i < stubs.size() && ok; i += 2) {
+            ok = stubs[i] != stubs[i+1];
+        }
+    }
+    if (!ok) gen_error("urquhart could not draw a graph without self-loops");
+
+    // edge i joins stubs[2i] and stubs[2i+1]
+    std::vector<std::vector<uint32_t>> incident(n);
+    for (size_t i = 0; i < stubs.size(); i += 2) {
+        incident[stubs[i]].push_back(i/2);
+        incident[stubs[i+1]].push_back(i/2);
+    }
+
+    sink.header(nb_edges, (uint64_t)n << (deg-1));
+    std::vector<BLit> cl;
+    for (uint32_t v = 0; v < n; v++) {
+        const uint32_t charge = v == 0;
+        // forbid every assignment to the incident edges of the wrong parity
+        for (uint32_t a = 0; a < (1U << deg); a++) {
+            uint32_t parity = 0;
+            for (uint32_t d = 0; d < deg; d++) parity ^= (a >> d) & 1;
+            if (parity == charge) continue;
+            cl.clear();
+            for (uint32_t d = 0; d < deg; d++) {
+                cl.push_back(BLit(incident[v][d], (a >> d) & 1));
+            }
+            sink.clause(cl);
+        }
+    }
+}
+
+///Injective map from n pigeons into n-1 holes, with both the pigeon->hole
+///variables x(i,j) and the hole->pigeon variables y(j,i), channelled. Rows
+///of both matrices are interchangeable. Unsatisfiable.
+inline void gen_channel(uint32_t n, ClauseSink& sink)
+{
+    if (n < 2) gen_error("channel needs n >= 2");
+    const uint64_t m = n-1;
+    check_size(2*m*n);
+    auto x = [&](uint32_t i, uint32_t j) { return (uint32_t)(i*m + j); };
+    auto y = [&](uint32_t j, uint32_t i) { return (uint32_t)(m*n + j*n + i); };
+
+    sink.header(2*m*n, n + n*choose2(m) + m*choose2(n) + 2*m*n);
+    std::vector<BLit> cl;
+    for (uint32_t i = 0; i < n; i++) {
+        cl.clear();
+        for (uint32_t j = 0; j < m; j++) cl.push_back(BLit(x(i, j), false));
+        sink.clause(cl);
+        for (uint32_t j = 0; j < m; j++) {
+            for (uint32_t j2 = j+1; j2 < m; j2++) {
+                cl = {BLit(x(i, j), true), BLit(x(i, j2), true)};
+                sink.clause(cl);
+            }
+        }
+    }
+    for (uint32_t j = 0; j < m; j++) {
+        for (uint32_t i = 0; i < n; i++) {
+            for (uint32_t i2 = i+1; i2 < n; i2++) {
+                cl = {BLit(y(j, i), true), BLit(y(j, i2), true)};
+                sink.clause(cl);
+            }
+        }
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t j = 0; j < m; j++) {
+            cl = {BLit(x(i, j), true), BLit(y(j, i), false)};
+            sink.clause(cl);
+            cl = {BLit(x(i, j), false), BLit(y(j, i), true)};
+            sink.clause(cl);
+        }
+    }
+}
+
+///Parity (counting mod 2) principle: a perfect matching of the complete
+///graph on 2n+1 vertices. Unsatisfiable, with all vertices interchangeable.
+inline void gen_counting(uint32_t n, ClauseSink& sink)
+{
+    if (n < 1) gen_error("counting needs n >= 1");
+    const uint64_t nb_vertices = 2*(uint64_t)n + 1;
+    check_size(choose2(nb_vertices));
+    auto e = [&](uint32_t u, uint32_t v) {
+        if (u > v) std::swap(u, v);
+        return (uint32_t)((uint64_t)v*(v-1)/2 + u);
+    };
+
+    sink.header(choose2(nb_vertices), nb_vertices + nb_vertices*choose2(nb_vertices-1));
+    std::vector<BLit> cl;
+    for (uint32_t u = 0; u < nb_vertices; u++) {
+        cl.clear();
+        for (uint32_t v = 0; v < nb_vertices; v++) {
+            if (v != u) cl.push_back(BLit(e(u, v), false));
+        }
+        sink.clause(cl);
+        for (uint32_t v = 0; v < nb_vertices; v++) {
+            if (v == u) continue;
+            for (uint32_t w = v+1; w < nb_vertices; w++) {
+                if (w == u) continue;
+                cl = {BLit(e(u, v), true), BLit(e(u, w), true)};
+                sink.clause(cl);
+            }
+        }
+    }
+}
+
+///copies identical copies, on disjoint variables, of one random k-CNF
+///with vars variables and cls clauses. The copies are interchangeable.
+///Every literal occurs in the base formula: a literal that does not gets
+///a color of its own in the graph, which hides the swaps of the copies.
+inline void gen_random_union(
+    uint32_t copies, uint32_t vars, uint64_t cls, uint32_t k,
+    uint64_t seed, ClauseSink& sink)
+{
+    if (copies < 1 || k < 1 || vars < k) {
+        gen_error("random union needs copies >= 1, k >= 1 and vars >= k");
+    }
+    if (cls*k < 2*(uint64_t)vars + k) {
+        gen_error("random union needs C*K >= 2*V + K, so that every literal occurs");
+    }
+    check_size((uint64_t)copies*vars);
+
+    std::mt19937_64 rnd(seed);
+    // the literals still to cover, drawn first in a random order
+    std::vector<BLit> pending;
+    pending.reserve(2*(size_t)vars);
+    for (uint32_t v = 0; v < vars; v++) {
+        pending.push_back(BLit(v, false));
+        pending.push_back(BLit(v, true));
+    }
+    std::shuffle(pending.begin(), pending.end(), rnd);
+    size_t next = 0;
+
+    std::vector<BLit> base;
+    base.reserve(cls*k);
+    for (uint64_t c = 0; c < cls; c++) {
+        const size_t start = base.size();
+        auto in_clause = [&](const BLit l) {
+            for (size_t i = start; i < base.size(); i++) {
+                if (base[i].var() == l.var()) return true;
+            }
+            return false;
+        };
+        while (base.size() - start < k) {
+            // the first pending literal whose variable is not in the
+            // clause yet; only complements of the clause can block all
+            size_t at = next;
+            while (at < pending.size() && in_clause(pending[at])) at++;
+            if (at < pending.size()) {
+                std::swap(pending[next], pending[at]);
+                base.push_back(pending[next++]);
+                continue;
+            }
+            const uint32_t v = rnd() % vars;
+            const BLit l(v, rnd() & 1);
+            if (!in_clause(l)) base.push_back(l);
+        }
+    }
+    assert(next == pending.size());
+
+    sink.header((uint64_t)copies*vars, (uint64_t)copies*cls);
+    std::vector<BLit> cl(k);
+    for (uint32_t i = 0; i < copies; i++) {
+        const uint32_t offs = i*vars;
+        for (uint64_t c = 0; c < cls; c++) {
+            for (uint32_t j = 0; j < k; j++) {
+                const BLit l = base[c*k + j];
+                cl[j] = BLit(l.var() + offs, l.sign());
+            }
+            sink.clause(cl);
+        }
+    }
+}
+
+inline const char* families_help()
+{
+    return
+        "  php HOLES                  pigeonhole, HOLES+1 pigeons\n"
+        "  clique N K C               N-vertex graph with a K-clique that is C-colorable\n"
+        "  urquhart N DEG             Tseitin on a random DEG-regular graph on N vertices\n"
+        "  channel N                  channelled injection of N pigeons into N-1 holes\n"
+        "  counting N                 perfect matching of the complete graph on 2N+1 vertices\n"
+        "  randunion COPIES V C K     COPIES disjoint copies of a random K-CNF, V vars, C clauses,\n"
+        "                             C*K >= 2*V + K\n";
+}
+
+///Generates the family with the given numeric parameters. Returns false
+///if the family is unknown or the number of parameters is wrong, throws
+///std::invalid_argument if the parameters are out of range.
+inline bool generate(
+    const std::string& family, const std::vector<uint64_t>& p,
+    uint64_t seed, ClauseSink& sink)
+{
+    // every parameter but the clause count of randunion is 32 bits wide
+    for (size_t i = 0; i < p.size(); i++) {
+        if (p[i] > UINT32_MAX && !(family == "randunion" && i == 2)) {
+            gen_error("parameter " + std::to_string(p[i]) + " of " + family + " is out of range");
+        }
+    }
+
+    if (family == "php" && p.size() == 1) {
+        gen_php(p[0], sink);
+    } else if (family == "clique" && p.size() == 3) {
+        gen_clique_coloring(p[0], p[1], p[2], sink);
+    } else if (family == "urquhart" && p.size() == 2) {
+        gen_urquhart(p[0], p[1], seed, sink);
+    } else if (family == "channel" && p.size() == 1) {
+        gen_channel(p[0], sink);
+    } else if (family == "counting" && p.size() == 1) {
+        gen_counting(p[0], sink);
+    } else if (family == "randunion" && p.size() == 4) {
+        gen_random_union(p[0], p[1], p[2], p[3], seed, sink);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+///Parses a "family:p1:p2:..." specification, as accepted by breakid-bench
+inline bool parse_spec(
+    const std::string& spec, std::string& family, std::vector<uint64_t>& params)
+{
+    params.clear();
+    size_t at = spec.find(':');
+    family = spec.substr(0, at);
+    while (at != std::string::npos) {
+        const size_t next = spec.find(':', at+1);
+        const std::string tok = spec.substr(at+1, next == std::string::npos ? next : next-at-1);
+        if (tok.empty() || tok.find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+        params.push_back(std::strtoull(tok.c_str(), nullptr, 10));
+        at = next;
+    }
+    return !family.empty();
+}
+
+}
+}
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include <string>
 #include <limits>
 #include <cstdint>
+#include "breakid.hpp"
 
 using std::vector;
 using std::string;
@@ -45,6 +46,30 @@ struct Config {
     uint32_t verbosity = 1;
     int64_t steps_lim = std::numeric_limits<int64_t>::max();
     int64_t remain_steps_lim;
+    BID::ProgressCallback progress_cb;
+    uint32_t progress_period = 10000;
+    BID::SplitHeuristic splitHeuristic = BID::SplitHeuristic::flm;
+    bool usePortfolio = false;
+    bool portfolioDone = false;
+    uint32_t searchThreads = 1;
+    BID::Detector detector = BID::Detector::bliss;
+    uint32_t randomizedFails = 16; ///<see BreakID::set_randomizedSearch()
+    bool autoSplitHeuristic = false;
+    bool autoSplitDone = false;
+    bool removeRedundantGens = false;
+    int64_t breakingClauseBudget = -1; ///<see BreakID::set_breakingBudget(), -1 for none
+    int64_t breakingAuxBudget = -1; ///<see BreakID::set_breakingBudget(), -1 for none
+    vector<double> varPriority; ///<see BreakID::set_var_priority(), empty for none
+    int64_t stabChainStepsLim = 500000000; ///<see Group::removeRedundantGenerators(), Group::getStats()
+
+    // Thresholds of the automatic splitting heuristic choice,
+    // see Graph::chooseSplitHeuristic()
+    double autoSplitNearDiscrete = 0.9; ///<singleton cells per vertex
+    uint32_t autoSplitSmallCells = 2; ///<vertices in the largest cell
+    uint32_t autoSplitLargeGraph = 1000000; ///<vertices
+    double autoSplitIrregular = 2.0; ///<coefficient of variation of literal degrees
+    double autoSplitDense = 64.0; ///<clauses per literal
+    double autoSplitHub = 50.0; ///<maximum literal degree over the mean degree
 };
 
 #endif
@@ -0,0 +1,101 @@
+/******************************************
+Copyright (c) 2024 Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+// Checks that the _size functions of the caller-owned buffer getters give
+// exactly the number of unsigneds their _into functions write, on the
+// pigeonhole formula, whose symmetries are all found as matrices.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "breakid_c.h"
+
+#define HOLES 4
+#define SLACK 8
+#define UNWRITTEN 0xdeadbeefu
+
+typedef size_t (*SizeFn)(BreakID*);
+typedef int (*IntoFn)(BreakID*, unsigned*, size_t);
+
+static int lit(unsigned pigeon, unsigned hole, int neg)
+{
+    return (int)(2*(pigeon*HOLES + hole) + (neg ? 1 : 0));
+}
+
+static int check(BreakID* bid, const char* name, SizeFn size_fn, IntoFn into_fn)
+{
+    const size_t sz = size_fn(bid);
+    unsigned* buf = (unsigned*)malloc((sz + SLACK) * sizeof(unsigned));
+    for (size_t i = 0; i < sz + SLACK; i++) buf[i] = UNWRITTEN;
+
+    int ok = 1;
+    if (sz > 0 && into_fn(bid, buf, sz - 1) != -1) {
+        fprintf(stderr, "%s: a buffer of size %zu - 1 was accepted\n", name, sz);
+        ok = 0;
+    } else if (into_fn(bid, buf, sz + SLACK) < 0) {
+        fprintf(stderr, "%s: a buffer of size %zu was refused\n", name, sz + SLACK);
+        ok = 0;
+    } else {
+        size_t written = sz + SLACK;
+        while (written > 0 && buf[written - 1] == UNWRITTEN) written--;
+        if (written != sz) {
+            fprintf(stderr, "%s: size %zu, but %zu written\n", name, sz, written);
+            ok = 0;
+        }
+    }
+    free(buf);
+    return ok;
+}
+
+int main(void)
+{
+    BreakID* bid = breakid_new();
+    breakid_set_verbosity(bid, 0);
+    breakid_start_dynamic_cnf(bid, (HOLES + 1)*HOLES);
+    int cl[HOLES];
+    for (unsigned p = 0; p <= HOLES; p++) {
+        for (unsigned h = 0; h < HOLES; h++) cl[h] = lit(p, h, 0);
+        breakid_add_clause(bid, cl, HOLES);
+    }
+    for (unsigned h = 0; h < HOLES; h++) {
+        for (unsigned p = 0; p <= HOLES; p++) {
+            for (unsigned q = p + 1; q <= HOLES; q++) {
+                cl[0] = lit(p, h, 1);
+                cl[1] = lit(q, h, 1);
+                breakid_add_clause(bid, cl, 2);
+            }
+        }
+    }
+    breakid_end_dynamic_cnf(bid);
+    breakid_detect_subgroups(bid);
+    breakid_break_symm(bid);
+
+    if (breakid_get_num_matrices(bid) == 0) {
+        fprintf(stderr, "no matrix detected\n");
+        return 1;
+    }
+    int ok = check(bid, "brk_cls", breakid_get_brk_cls_size, breakid_get_brk_cls_into);
+    ok &= check(bid, "generators", breakid_get_generators_size, breakid_get_generators_into);
+    ok &= check(bid, "matrices", breakid_get_matrices_size, breakid_get_matrices_into);
+    breakid_del(bid);
+    return ok ? 0 : 1;
+}